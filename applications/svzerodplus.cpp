@@ -57,6 +57,7 @@ PYBIND11_MODULE(svzerodplus, m) {
       .def("run", &Solver::run)
       .def("get_single_result", &Solver::get_single_result)
       .def("get_single_result_avg", &Solver::get_single_result_avg)
+      .def("get_num_cycles", &Solver::get_num_cycles)
       .def("get_full_result", [](Solver& solver) {
         py::module_ pd = py::module_::import("pandas");
         py::module_ io = py::module_::import("io");
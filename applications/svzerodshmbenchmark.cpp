@@ -0,0 +1,216 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file svzerodshmbenchmark.cpp
+ * @brief Mock 3D driver for the shared-memory coupling server
+ */
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "ShmTransport.h"
+
+extern char** environ;
+
+/**
+ * @brief Mock of a 3D solver coupled to the 0D model
+ *
+ * Computes the boundary values of the coupling blocks from the responses of
+ * the 0D model (explicit coupling): A pulsatile flow minus a leakage
+ * proportional to the pressure at FLOW blocks and a pulsatile pressure plus a
+ * resistive pressure drop at PRESSURE blocks.
+ */
+struct Mock3D {
+  std::vector<bool> block_is_flow;  ///< Whether each block prescribes a flow
+
+  /**
+   * @brief Compute the boundary values for the next time step
+   *
+   * @param time Current time
+   * @param responses Responses of the 0D model in the last time step
+   * @param values Boundary values of the coupling blocks
+   */
+  void solve(double time, const std::vector<double>& responses,
+             std::vector<double>& values) const {
+    double pulse = std::sin(2.0 * M_PI * time);
+    for (size_t i = 0; i < values.size(); i++) {
+      if (block_is_flow[i]) {
+        values[i] = 1.0 + 0.5 * pulse - 1.0e-6 * responses[i];
+      } else {
+        values[i] = 1000.0 + 100.0 * pulse + 10.0 * responses[i];
+      }
+    }
+  }
+};
+
+/**
+ * @brief Print statistics of the round-trip times of time steps
+ *
+ * @param label Label of the statistics
+ * @param times Round-trip times in seconds (are sorted)
+ */
+static void print_statistics(const std::string& label,
+                             std::vector<double>& times) {
+  std::sort(times.begin(), times.end());
+  double total = 0.0;
+  for (double time : times) {
+    total += time;
+  }
+  printf("%-12s median %8.2f us   p99 %8.2f us   max %8.2f us   %10.0f steps/s\n",
+         label.c_str(), 1e6 * times[times.size() / 2],
+         1e6 * times[times.size() * 99 / 100], 1e6 * times.back(),
+         double(times.size()) / total);
+}
+
+/**
+ *
+ * @brief Shared-memory coupling benchmark main routine
+ *
+ * Starts a shared-memory server and couples it to a mock 3D solver. The same
+ * coupled simulation is run with a 0D model in the benchmark process through
+ * direct calls of the interface library. The results of both runs must be
+ * identical. The round-trip times of the time steps are reported for both.
+ *
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ * @return Return code (1 if the results differ)
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 3 || argc > 6) {
+    std::cout << "Usage: svzerodshmbenchmark path/to/config.json path/to/svzerodshmserver [num_steps] [server_cpu] [client_cpu]" << std::endl;
+    return 1;
+  }
+  int num_steps = (argc > 3) ? std::stoi(argv[3]) : 10000;
+  if (argc > 5) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(std::stoi(argv[5]), &cpus);
+    sched_setaffinity(0, sizeof(cpus), &cpus);
+  }
+
+  // Start the server
+  std::string segment_name = "/svzerod_benchmark_" + std::to_string(getpid());
+  std::vector<std::string> server_args = {argv[2], argv[1], segment_name};
+  if (argc > 4) {
+    server_args.push_back(argv[4]);
+  }
+  std::vector<char*> server_argv;
+  for (auto& arg : server_args) {
+    server_argv.push_back(arg.data());
+  }
+  server_argv.push_back(nullptr);
+  pid_t server_pid;
+  if (posix_spawn(&server_pid, argv[2], nullptr, nullptr, server_argv.data(),
+                  environ) != 0) {
+    std::cerr << "[svzerodshmbenchmark] Error: Could not start " << argv[2] << std::endl;
+    return 1;
+  }
+
+  int num_errors = 0;
+  try {
+    auto channel = ShmChannel::open(segment_name, 60.0);
+    int num_blocks = channel.segment->num_blocks;
+    Mock3D mock_3d;
+    for (int i = 0; i < num_blocks; i++) {
+      mock_3d.block_is_flow.push_back(channel.segment->block_is_flow[i]);
+    }
+
+    // Same model in this process
+    ShmServer direct(argv[1]);
+    ShmMessage request;
+    ShmMessage response;
+
+    const double step_size = 0.01;
+    request.values[0] = step_size;
+    request.command = ShmCommand::set_external_step_size;
+    direct.handle(request, response);
+    channel.request(ShmCommand::set_external_step_size, 0.0, request.values,
+                    nullptr);
+
+    std::vector<double> values(num_blocks);
+    std::vector<double> responses(num_blocks, 0.0);
+    std::vector<double> responses_direct(num_blocks, 0.0);
+    std::vector<double> times(num_steps);
+    std::vector<double> times_direct(num_steps);
+    request.command = ShmCommand::step;
+    for (int step = 0; step < num_steps; step++) {
+      double time = step * step_size;
+      mock_3d.solve(time, responses, values);
+
+      auto start = std::chrono::steady_clock::now();
+      num_errors += channel.request(ShmCommand::step, time, values.data(),
+                                    responses.data());
+      auto end = std::chrono::steady_clock::now();
+      times[step] = std::chrono::duration<double>(end - start).count();
+
+      start = std::chrono::steady_clock::now();
+      request.time = time;
+      std::copy(values.begin(), values.end(), request.values);
+      direct.handle(request, response);
+      std::copy_n(response.values, num_blocks, responses_direct.begin());
+      end = std::chrono::steady_clock::now();
+      times_direct[step] = std::chrono::duration<double>(end - start).count();
+      num_errors += response.status;
+
+      if (responses != responses_direct) {
+        std::cerr << "[svzerodshmbenchmark] Error: Different results in time step " << step << std::endl;
+        num_errors++;
+        break;
+      }
+    }
+    channel.request(ShmCommand::shutdown, 0.0, nullptr, nullptr);
+
+    print_statistics("shm", times);
+    print_statistics("direct", times_direct);
+  } catch (const std::exception& e) {
+    std::cerr << "[svzerodshmbenchmark] Error: " << e.what() << std::endl;
+    kill(server_pid, SIGTERM);
+    shm_unlink(segment_name.c_str());
+    num_errors++;
+  }
+
+  int server_status = 0;
+  waitpid(server_pid, &server_status, 0);
+  if (!WIFEXITED(server_status) || (WEXITSTATUS(server_status) != 0)) {
+    num_errors++;
+  }
+
+  return (num_errors > 0) ? 1 : 0;
+}
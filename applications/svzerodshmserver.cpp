@@ -0,0 +1,84 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file svzerodshmserver.cpp
+ * @brief Shared-memory coupling server of svZeroDSolver
+ */
+#include <sched.h>
+
+#include <iostream>
+
+#include "ShmTransport.h"
+
+/**
+ *
+ * @brief Shared-memory coupling server main routine
+ *
+ * Runs a 0D model in its own process for an external solver (e.g. a 3D
+ * solver) that exchanges the boundary values of the coupling blocks through
+ * the shared-memory segment (see ShmChannel). The server can be pinned to a
+ * core to avoid interference with the external solver.
+ *
+ * @param argc Number of command line arguments
+ * @param argv Command line arguments
+ * @return Return code
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 3 || argc > 5) {
+    std::cout << "Usage: svzerodshmserver path/to/config.json /segment_name [cpu] [num_spins]" << std::endl;
+    return 1;
+  }
+
+  // Pin the server to a core
+  if (argc > 3) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(std::stoi(argv[3]), &cpus);
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      std::cerr << "[svzerodshmserver] Warning: Could not pin the server to core " << argv[3] << "." << std::endl;
+    }
+  }
+
+  try {
+    ShmServer server(argv[1]);
+    auto channel = ShmChannel::create(argv[2]);
+    if (argc > 4) {
+      channel.num_spins = std::stoi(argv[4]);
+    }
+    server.describe(*channel.segment);
+    channel.set_ready();
+    server.serve(channel);
+  } catch (const std::exception& e) {
+    std::cerr << "[svzerodshmserver] Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
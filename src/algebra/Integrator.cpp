@@ -30,8 +30,15 @@
 
 #include "Integrator.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+
 Integrator::Integrator(Model* model, double time_step_size, double rho,
-                       double atol, int max_iter) {
+                       double atol, int max_iter,
+                       double jacobian_reuse_threshold,
+                       LinearSolverType linear_solver) {
   this->model = model;
   alpha_m = 0.5 * (3.0 - rho) / (1.0 + rho);
   alpha_f = 1.0 / (1.0 + rho);
@@ -42,13 +49,15 @@ Integrator::Integrator(Model* model, double time_step_size, double rho,
   y_coeff_jacobian = alpha_f * y_coeff;
 
   size = model->dofhandler.size();
-  system = SparseSystem(size);
+  system = SparseSystem(size, linear_solver);
   this->time_step_size = time_step_size;
   this->atol = atol;
   this->max_iter = max_iter;
+  this->jacobian_reuse_threshold = jacobian_reuse_threshold;
 
   y_af = Eigen::Matrix<double, Eigen::Dynamic, 1>(size);
   ydot_am = Eigen::Matrix<double, Eigen::Dynamic, 1>(size);
+  work_state = State(size);
 
   // Make some memory reservations
   system.reserve(model);
@@ -66,18 +75,121 @@ void Integrator::clean() {
 }
 
 void Integrator::update_params(double time_step_size) {
-  this->time_step_size = time_step_size;
-  y_coeff = gamma * time_step_size;
-  y_coeff_jacobian = alpha_f * y_coeff;
-  model->update_constant(system);
-  model->update_time(system, 0.0);
+  set_time_step_size(time_step_size);
+
+  // Outdated factorization is not valid if the constant contributions to the
+  // jacobian changed
+  constant_values_F = system.F.coeffs();
+  constant_values_E = system.E.coeffs();
+  if (model->update_changed_constant(system)) {
+    if ((constant_values_F.size() != system.F.coeffs().size()) ||
+        (constant_values_E.size() != system.E.coeffs().size()) ||
+        (constant_values_F != system.F.coeffs()).any() ||
+        (constant_values_E != system.E.coeffs()).any()) {
+      residual_contraction = 1.0;
+    }
+  }
 }
 
 State Integrator::step(const State& old_state, double time) {
+  State new_state;
+  if (!solve_time_step(old_state, new_state, time)) {
+    throw std::runtime_error(
+        "Maximum number of non-linear iterations reached.");
+  }
+  return new_state;
+}
+
+void Integrator::step(const State& state, State& new_state, double time) {
+  if (!solve_time_step(state, new_state, time)) {
+    throw std::runtime_error(
+        "Maximum number of non-linear iterations reached.");
+  }
+}
+
+void Integrator::step_in_place(State& state, double time) {
+  if (!solve_time_step(state, work_state, time)) {
+    throw std::runtime_error(
+        "Maximum number of non-linear iterations reached.");
+  }
+  state.y = work_state.y;
+  state.ydot = work_state.ydot;
+}
+
+bool Integrator::solve_sensitivity(
+    int eqn, Eigen::Matrix<double, Eigen::Dynamic, 1>& dy_dc) {
+  // The system still holds the solution-dependent contributions of the
+  // converged iterate of the last time step
+  system.update_jacobian(alpha_m, y_coeff_jacobian);
+  if (!system.jacobian_is_factorized()) {
+    system.factorize();
+  }
+  if (system.solver->info() != Eigen::Success) {
+    return false;
+  }
+
+  // Increment in ydot for a unit increment of c_i (residual is -c_i)
+  system.residual.setZero();
+  system.residual[eqn] = -1.0;
+  system.solve();
+  dy_dc = system.dydot * y_coeff;
+  return true;
+}
+
+bool Integrator::solve_steady_state(State& state, double time) {
+  State steady_state(size);
+  steady_state.y = state.y;
+
+  // Evaluate time-dependent element contributions in system
+  model->update_time(system, time);
+
+  // Outdated factorization is not valid for time steps
+  residual_contraction = 1.0;
+
+  // Non-linear Newton-Raphson iterations
+  for (size_t i = 0; i < max_iter; i++) {
+    // Update solution-dependent element contribitions
+    model->update_solution(system, steady_state.y, steady_state.ydot);
+
+    // Evaluate residual
+    system.update_residual(steady_state.y, steady_state.ydot);
+
+    // Check termination criterium
+    if (system.residual.cwiseAbs().maxCoeff() < atol) {
+      state = std::move(steady_state);
+      return true;
+    }
+
+    // Evaluate and factorize Jacobian of the steady system (dr/dy)
+    system.update_jacobian(0.0, 1.0);
+    if (!system.jacobian_is_factorized()) {
+      system.factorize();
+    }
+    if (system.solver->info() != Eigen::Success) {
+      return false;
+    }
+
+    // Solve system for increment in y
+    system.solve();
+    if (!system.dydot.allFinite()) {
+      return false;
+    }
+
+    // Perform post-solve actions on blocks
+    model->post_solve(steady_state.y);
+
+    // Update the solution
+    steady_state.y += system.dydot;
+  }
+
+  return false;
+}
+
+bool Integrator::solve_time_step(const State& old_state, State& new_state,
+                                 double time) {
   // Predictor: Constant y, consistent ydot
-  State new_state = State::Zero(size);
-  new_state.ydot += old_state.ydot * ydot_init_coeff;
-  new_state.y += old_state.y;
+  new_state.ydot = old_state.ydot * ydot_init_coeff;
+  new_state.y = old_state.y;
 
   // Determine new time (evaluate terms at generalized mid-point)
   double new_time = time + alpha_f * time_step_size;
@@ -89,12 +201,11 @@ State Integrator::step(const State& old_state, double time) {
   n_iter++;
 
   // Non-linear Newton-Raphson iterations
+  double residual_norm_prev = 0.0;
   for (size_t i = 0; i < max_iter; i++) {
     // Initiator: Evaluate the iterates at the intermediate time levels
-    ydot_am.setZero();
-    y_af.setZero();
-    ydot_am += old_state.ydot + (new_state.ydot - old_state.ydot) * alpha_m;
-    y_af += old_state.y + (new_state.y - old_state.y) * alpha_f;
+    ydot_am = old_state.ydot + (new_state.ydot - old_state.ydot) * alpha_m;
+    y_af = old_state.y + (new_state.y - old_state.y) * alpha_f;
 
     // Update solution-dependent element contribitions
     model->update_solution(system, y_af, ydot_am);
@@ -103,18 +214,34 @@ State Integrator::step(const State& old_state, double time) {
     system.update_residual(y_af, ydot_am);
 
     // Check termination criterium
-    if (system.residual.cwiseAbs().maxCoeff() < atol) {
-      break;
+    double residual_norm = system.residual.cwiseAbs().maxCoeff();
+    if (i > 0) {
+      residual_contraction = residual_norm / residual_norm_prev;
+    }
+    residual_norm_prev = residual_norm;
+    if (residual_norm < atol) {
+      return true;
     }
 
     // Abort if maximum number of non-linear iterations is reached
     else if (i == max_iter - 1) {
-      throw std::runtime_error(
-          "Maximum number of non-linear iterations reached.");
+      return false;
     }
 
-    // Evaluate Jacobian
-    system.update_jacobian(alpha_m, y_coeff_jacobian);
+    // Evaluate and factorize Jacobian unless the current factorization can be
+    // reused
+    if ((jacobian_reuse_threshold > 0.0) && system.is_factorized() &&
+        (residual_contraction < jacobian_reuse_threshold)) {
+      n_saved_factorizations++;
+    } else {
+      system.update_jacobian(alpha_m, y_coeff_jacobian);
+      if (system.jacobian_is_factorized()) {
+        n_saved_factorizations++;
+      } else {
+        system.factorize();
+      }
+      residual_contraction = 0.0;
+    }
 
     // Solve system for increment in ydot
     system.solve();
@@ -130,9 +257,138 @@ State Integrator::step(const State& old_state, double time) {
     n_nonlin_iter++;
   }
 
+  return false;
+}
+
+State Integrator::step_adaptive(const State& old_state, double& time,
+                                double end_time) {
+  if (y_scale.size() != size) {
+    y_scale = old_state.y.cwiseAbs();
+
+    // Variables of the same kind (e.g. all flows or all pressures) share the
+    // scale of the error estimate
+    std::map<std::string, int> group_map;
+    adaptive_groups.resize(size);
+    for (size_t i = 0; i < size; i++) {
+      auto& name = model->dofhandler.variables[i];
+      adaptive_groups[i] =
+          group_map.insert({name.substr(0, name.find(':')), group_map.size()})
+              .first->second;
+    }
+    adaptive_group_scale.resize(group_map.size());
+  }
+
+  State new_state;
+  while (true) {
+    double time_step_size_trial =
+        std::min(adaptive_time_step_size, end_time - time);
+    set_time_step_size(time_step_size_trial);
+    bool converged = solve_time_step(old_state, new_state, time);
+    bool is_min_step = time_step_size_trial <= adaptive_min_time_step_size;
+
+    // Without two previous steps, there is no error estimate. Accept the
+    // step and keep the time step size.
+    if (converged && (n_accepted_steps < 2)) {
+      break;
+    }
+
+    // Estimate the local error by comparison with a linear extrapolation of
+    // the solution at the generalized mid-points of the previous two steps
+    // (other than the solution at the end of the step, the solution at the
+    // generalized mid-point satisfies algebraic constraints)
+    double error = 0.0;
+    if (converged) {
+      std::fill(adaptive_group_scale.begin(), adaptive_group_scale.end(), 0.0);
+      for (size_t i = 0; i < size; i++) {
+        y_scale[i] = std::max(y_scale[i], std::abs(y_af[i]));
+        adaptive_group_scale[adaptive_groups[i]] =
+            std::max(adaptive_group_scale[adaptive_groups[i]], y_scale[i]);
+      }
+      double ratio = (time + alpha_f * time_step_size_trial -
+                      adaptive_time_af[0]) /
+                     (adaptive_time_af[0] - adaptive_time_af[1]);
+      for (size_t i = 0; i < size; i++) {
+        // Skip quantities that were modified in the post-solve step of the
+        // blocks (their time derivative does not match the solution)
+        double defect = new_state.y[i] - old_state.y[i] -
+                        time_step_size_trial *
+                            ((1.0 - gamma) * old_state.ydot[i] +
+                             gamma * new_state.ydot[i]);
+        if (std::abs(defect) > 1e-8 * (std::abs(new_state.y[i]) + atol)) {
+          continue;
+        }
+        double error_i =
+            std::abs(y_af[i] - adaptive_y_af[0][i] -
+                     ratio * (adaptive_y_af[0][i] - adaptive_y_af[1][i])) /
+            (adaptive_tolerance * adaptive_group_scale[adaptive_groups[i]] +
+             atol);
+        error = std::max(error, error_i);
+      }
+    }
+    double factor = (error > 0.0) ? 0.9 / std::sqrt(error) : 2.0;
+    factor = std::clamp(factor, 0.5, 2.0);
+
+    // Accept step if the error is small enough (steps with minimum time step
+    // size are always accepted)
+    if (converged && ((error <= 1.0) || is_min_step)) {
+      // Keep the time step size (and thereby the jacobian) if only a slight
+      // increase is possible
+      if ((factor < 1.0) || (factor > 1.2)) {
+        adaptive_time_step_size =
+            std::clamp(time_step_size_trial * factor,
+                       adaptive_min_time_step_size, adaptive_max_time_step_size);
+      }
+      break;
+    }
+
+    if (!converged && is_min_step) {
+      throw std::runtime_error(
+          "Maximum number of non-linear iterations reached.");
+    }
+
+    // Reject step and retry with smaller time step size
+    n_rejected_steps++;
+    adaptive_time_step_size = std::max(
+        time_step_size_trial * (converged ? std::min(factor, 0.9) : 0.5),
+        adaptive_min_time_step_size);
+  }
+
+  n_accepted_steps++;
+  std::swap(adaptive_y_af[0], adaptive_y_af[1]);
+  adaptive_y_af[0] = y_af;
+  adaptive_time_af[1] = adaptive_time_af[0];
+  adaptive_time_af[0] = time + alpha_f * time_step_size;
+  time += time_step_size;
   return new_state;
 }
 
+void Integrator::setup_adaptive_time_stepping(double tolerance,
+                                              double min_time_step_size,
+                                              double max_time_step_size) {
+  adaptive_tolerance = tolerance;
+  adaptive_min_time_step_size = min_time_step_size;
+  adaptive_max_time_step_size = max_time_step_size;
+  adaptive_time_step_size = std::min(time_step_size, max_time_step_size);
+}
+
+void Integrator::set_time_step_size(double time_step_size) {
+  if (time_step_size == this->time_step_size) {
+    return;
+  }
+  this->time_step_size = time_step_size;
+  y_coeff = gamma * time_step_size;
+  y_coeff_jacobian = alpha_f * y_coeff;
+
+  // Outdated factorization is not valid for new time step size
+  residual_contraction = 1.0;
+}
+
 double Integrator::avg_nonlin_iter() {
   return (double)n_nonlin_iter / (double)n_iter;
 }
+
+int Integrator::num_saved_factorizations() { return n_saved_factorizations; }
+
+int Integrator::num_accepted_steps() { return n_accepted_steps; }
+
+int Integrator::num_rejected_steps() { return n_rejected_steps; }
@@ -35,6 +35,7 @@
 #define SVZERODSOLVER_ALGEBRA_INTEGRATOR_HPP_
 
 #include <Eigen/Dense>
+#include <vector>
 
 #include "Model.h"
 #include "State.h"
@@ -107,6 +108,14 @@
  * \gamma \Delta t_n.
  * \f]
  *
+ * The factorization of \f$\mathbf K\f$ is reused whenever the values of
+ * \f$\mathbf K\f$ did not change since the last factorization. For linear
+ * models, \f$\mathbf K\f$ only depends on the time step size and is therefore
+ * factorized only once. Optionally, the factorization of an outdated
+ * \f$\mathbf K\f$ is kept across iterations and time steps (modified Newton
+ * method) as long as the residual contracts by at least the factor
+ * `jacobian_reuse_threshold` per iteration.
+ *
  */
 
 //  * 3. \f$\textbf{Multi-corrector step}\f$: Then, for \f$k \in \left[0,
@@ -149,8 +158,25 @@ class Integrator {
   int size{0};
   int n_iter{0};
   int n_nonlin_iter{0};
+  int n_saved_factorizations{0};
+  double jacobian_reuse_threshold{0.0};
+  double residual_contraction{1.0};
+  double adaptive_tolerance{0.0};
+  double adaptive_time_step_size{0.0};
+  double adaptive_min_time_step_size{0.0};
+  double adaptive_max_time_step_size{0.0};
+  double adaptive_time_af[2]{0.0, 0.0};
+  int n_accepted_steps{0};
+  int n_rejected_steps{0};
+  Eigen::Matrix<double, Eigen::Dynamic, 1> y_scale;
+  Eigen::Matrix<double, Eigen::Dynamic, 1> adaptive_y_af[2];
+  std::vector<int> adaptive_groups;
+  std::vector<double> adaptive_group_scale;
   Eigen::Matrix<double, Eigen::Dynamic, 1> y_af;
   Eigen::Matrix<double, Eigen::Dynamic, 1> ydot_am;
+  Eigen::Array<double, Eigen::Dynamic, 1> constant_values_F;
+  Eigen::Array<double, Eigen::Dynamic, 1> constant_values_E;
+  State work_state;
   SparseSystem system;
   Model* model{nullptr};
 
@@ -163,9 +189,14 @@ class Integrator {
    * @param rho Spectral radius for generalized-alpha step
    * @param atol Absolut tolerance for non-linear iteration termination
    * @param max_iter Maximum number of non-linear iterations
+   * @param jacobian_reuse_threshold Maximum residual contraction ratio per
+   * non-linear iteration for which the factorization of an outdated jacobian
+   * is kept (0 disables the reuse of outdated jacobians)
+   * @param linear_solver Type of the linear solver
    */
   Integrator(Model* model, double time_step_size, double rho, double atol,
-             int max_iter);
+             int max_iter, double jacobian_reuse_threshold = 0.0,
+             LinearSolverType linear_solver = LinearSolverType::automatic);
 
   /**
    * @brief Construct a new Integrator object
@@ -189,6 +220,11 @@ class Integrator {
    * @brief Update integrator parameter and system matrices with model parameter
    * updates.
    *
+   * Only the constant contributions of blocks with changed parameters (see
+   * Model::set_parameter_changed) are reassembled. A factorization of an
+   * outdated jacobian is kept if neither the time step size nor the constant
+   * contributions to the jacobian changed.
+   *
    * @param time_step_size Time step size for 0D model
    */
   void update_params(double time_step_size);
@@ -202,6 +238,111 @@ class Integrator {
    */
   State step(const State& state, double time);
 
+  /**
+   * @brief Perform a time step into a given state
+   *
+   * Other than step(), this does not allocate any memory if the new state has
+   * the size of the system.
+   *
+   * @param state Current state
+   * @param new_state New state
+   * @param time Current time
+   */
+  void step(const State& state, State& new_state, double time);
+
+  /**
+   * @brief Perform a time step in place
+   *
+   * Other than step(), this does not allocate any memory. The new state is
+   * computed in a work state of the integrator and copied to the given state.
+   * The given state keeps its memory, i.e. pointers to its data stay valid.
+   *
+   * @param state Current state (is replaced by the new state)
+   * @param time Current time
+   */
+  void step_in_place(State& state, double time);
+
+  /**
+   * @brief Compute the sensitivity of the last time step to a constant
+   * contribution of an equation
+   *
+   * Linearizes the last time step at its converged solution and computes
+   * \f$\partial \mathbf{y}_{n+1} / \partial c_i\f$ for a change of the entry
+   * \f$c_i\f$ of \f$\mathbf{c}\f$ with one back-substitution,
+   * \f[
+   * \frac{\partial \mathbf{y}_{n+1}}{\partial c_i} = - \gamma \Delta t
+   * \mathbf{K}^{-1} \mathbf{e}_i.
+   * \f]
+   * The jacobian is only factorized if it changed since the last
+   * factorization (i.e. never for linear models). Must be called after a
+   * converged time step and before any other update of the system.
+   *
+   * @param eqn Index of the equation
+   * @param dy_dc Sensitivity of the new solution
+   * @return Whether the factorization of the jacobian succeeded
+   */
+  bool solve_sensitivity(int eqn,
+                         Eigen::Matrix<double, Eigen::Dynamic, 1>& dy_dc);
+
+  /**
+   * @brief Solve for the steady state of the model
+   *
+   * Sets \f$\dot{\mathbf{y}} = \mathbf{0}\f$ and solves
+   * \f$\mathbf{F} \cdot \mathbf{y} + \mathbf{c}(\mathbf{y}, \mathbf{0}, t) =
+   * \mathbf{0}\f$ with the Newton-Raphson method. The model is expected to be
+   * converted to a steady model (see Model::to_steady).
+   *
+   * @param state Initial guess (is replaced by the steady state if the
+   * non-linear iterations converge)
+   * @param time Time at which time-dependent contributions are evaluated
+   * @return Whether the non-linear iterations converged
+   */
+  bool solve_steady_state(State& state, double time);
+
+  /**
+   * @brief Set up adaptive time stepping
+   *
+   * The initial time step size is the time step size of the integrator.
+   *
+   * @param tolerance Relative tolerance for the local error estimate
+   * @param min_time_step_size Minimum time step size
+   * @param max_time_step_size Maximum time step size
+   */
+  void setup_adaptive_time_stepping(double tolerance, double min_time_step_size,
+                                    double max_time_step_size);
+
+  /**
+   * @brief Perform a time step with adaptive time step size
+   *
+   * The local error of a step is estimated by the deviation of the solution
+   * at the generalized mid-point \f$t_{n+\alpha_f}\f$ from the linear
+   * extrapolation of the mid-point solutions of the previous two steps,
+   *
+   * \f[
+   * e_j = \frac{|y_{n+\alpha_f,j} - \tilde{y}_{n+\alpha_f,j}|}
+   * {\epsilon_\text{rel} \max_{k \in G(j)} \max_{m \leq n} |y_{m+\alpha_f,k}|
+   * + \epsilon_\text{abs}},
+   * \f]
+   *
+   * where \f$G(j)\f$ are the variables of the same kind as \f$j\f$ (e.g. all
+   * flows) and \f$\epsilon_\text{abs}\f$ is the absolute tolerance of the
+   * non-linear iterations. Other than the solution at the end of a step, the
+   * mid-point solution satisfies algebraic constraints of the DAE system.
+   * Variables that were modified in Block::post_solve are excluded.
+   *
+   * The step is rejected and repeated with a smaller time step size if
+   * \f$\max_j e_j > 1\f$ or if the non-linear iterations do not converge.
+   * Otherwise, the time step size of the next step is adapted according to
+   * the error estimate. Steps with the minimum time step size are always
+   * accepted.
+   *
+   * @param state Current state
+   * @param time Current time (is advanced by the accepted time step size)
+   * @param end_time Time that is not stepped over
+   * @return New state
+   */
+  State step_adaptive(const State& state, double& time, double end_time);
+
   /**
    * @brief Get average number of nonlinear iterations in all step calls
    *
@@ -209,6 +350,49 @@ class Integrator {
    *
    */
   double avg_nonlin_iter();
+
+  /**
+   * @brief Get number of non-linear iterations without a new factorization of
+   * the jacobian in all step calls
+   *
+   * @return Number of saved factorizations of the jacobian
+   *
+   */
+  int num_saved_factorizations();
+
+  /**
+   * @brief Get number of accepted steps with adaptive time step size
+   *
+   * @return Number of accepted steps
+   *
+   */
+  int num_accepted_steps();
+
+  /**
+   * @brief Get number of rejected steps with adaptive time step size
+   *
+   * @return Number of rejected steps
+   *
+   */
+  int num_rejected_steps();
+
+ private:
+  /**
+   * @brief Solve the non-linear system of a time step
+   *
+   * @param old_state Current state
+   * @param new_state New state
+   * @param time Current time
+   * @return Whether the non-linear iterations converged
+   */
+  bool solve_time_step(const State& old_state, State& new_state, double time);
+
+  /**
+   * @brief Change the time step size without updating the model
+   *
+   * @param time_step_size New time step size
+   */
+  void set_time_step_size(double time_step_size);
 };
 
 #endif  // SVZERODSOLVER_ALGEBRA_INTEGRATOR_HPP_
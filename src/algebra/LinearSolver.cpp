@@ -0,0 +1,457 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "LinearSolver.h"
+
+#include <algorithm>
+
+/**
+ * @brief Solve with the supernodal LU factors of a SparseLU factorization in
+ * place
+ *
+ * Same forward and backward substitution as in `SparseLU::solve`, but with a
+ * preallocated work vector for the scatter operations in the forward
+ * substitution with L.
+ *
+ * @tparam MatrixL Type of the supernodal matrix L
+ * @tparam MatrixU Type of the sparse matrix U (without the supernodes)
+ * @param L Supernodal matrix L (with unit diagonal) and supernodes of U
+ * @param U Off-supernode entries of U
+ * @param x Row-permuted right-hand side (is overwritten by the solution)
+ * @param work Work vector of the size of x (must be zero, is zero on return)
+ */
+template <typename MatrixL, typename MatrixU>
+static void solve_supernodal(const MatrixL &L, const MatrixU &U,
+                             Eigen::Matrix<double, Eigen::Dynamic, 1> &x,
+                             Eigen::Matrix<double, Eigen::Dynamic, 1> &work) {
+  typedef Eigen::Map<const Eigen::MatrixXd, 0, Eigen::OuterStride<>>
+      SupernodeBlock;
+  typedef Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 1>> Segment;
+
+  // Forward substitution with L
+  for (int k = 0; k <= L.nsuper(); k++) {
+    int fsupc = L.supToCol()[k];
+    int istart = L.rowIndexPtr()[fsupc];
+    int nsupr = L.rowIndexPtr()[fsupc + 1] - istart;
+    int nsupc = L.supToCol()[k + 1] - fsupc;
+    int nrow = nsupr - nsupc;
+    if (nsupc == 1) {
+      typename MatrixL::InnerIterator it(L, fsupc);
+      for (++it; it; ++it) {
+        x[it.row()] -= x[fsupc] * it.value();
+      }
+    } else {
+      int luptr = L.colIndexPtr()[fsupc];
+      int lda = L.colIndexPtr()[fsupc + 1] - luptr;
+      SupernodeBlock A(L.valuePtr() + luptr, nsupc, nsupc,
+                       Eigen::OuterStride<>(lda));
+      Segment x_supernode(x.data() + fsupc, nsupc);
+      A.triangularView<Eigen::UnitLower>().solveInPlace(x_supernode);
+      SupernodeBlock B(L.valuePtr() + luptr + nsupc, nrow, nsupc,
+                       Eigen::OuterStride<>(lda));
+      work.head(nrow).noalias() = B * x_supernode;
+      for (int i = 0; i < nrow; i++) {
+        x[L.rowIndex()[istart + nsupc + i]] -= work[i];
+        work[i] = 0.0;
+      }
+    }
+  }
+
+  // Backward substitution with U
+  for (int k = L.nsuper(); k >= 0; k--) {
+    int fsupc = L.supToCol()[k];
+    int luptr = L.colIndexPtr()[fsupc];
+    int lda = L.colIndexPtr()[fsupc + 1] - luptr;
+    int nsupc = L.supToCol()[k + 1] - fsupc;
+    if (nsupc == 1) {
+      x[fsupc] /= L.valuePtr()[luptr];
+    } else {
+      SupernodeBlock A(L.valuePtr() + luptr, nsupc, nsupc,
+                       Eigen::OuterStride<>(lda));
+      Segment x_supernode(x.data() + fsupc, nsupc);
+      A.triangularView<Eigen::Upper>().solveInPlace(x_supernode);
+    }
+    for (int jcol = fsupc; jcol < fsupc + nsupc; jcol++) {
+      for (typename MatrixU::InnerIterator it(U, jcol); it; ++it) {
+        x[it.index()] -= x[jcol] * it.value();
+      }
+    }
+  }
+}
+
+void SparseLUSolver::analyze_pattern(
+    const Eigen::SparseMatrix<double> &matrix) {
+  lu.analyzePattern(matrix);
+  buffer = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(matrix.rows());
+  work = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(matrix.rows());
+}
+
+void SparseLUSolver::factorize(const Eigen::SparseMatrix<double> &matrix) {
+  lu.factorize(matrix);
+}
+
+void SparseLUSolver::solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+                           Eigen::Matrix<double, Eigen::Dynamic, 1> &x) {
+  // Equivalent to lu.solve(rhs) without temporary vectors
+  x.noalias() = lu.rowsPermutation() * rhs;
+  auto factors = lu.matrixU();
+  solve_supernodal(factors.m_mapL, factors.m_mapU, x, work);
+  buffer.noalias() = lu.colsPermutation().inverse() * x;
+  x.swap(buffer);
+}
+
+Eigen::ComputationInfo SparseLUSolver::info() const { return lu.info(); }
+
+void DenseLUSolver::analyze_pattern(const Eigen::SparseMatrix<double> &matrix) {
+  matrix_dense = Eigen::MatrixXd::Zero(matrix.rows(), matrix.cols());
+  lu = Eigen::PartialPivLU<Eigen::MatrixXd>(matrix.rows());
+}
+
+void DenseLUSolver::factorize(const Eigen::SparseMatrix<double> &matrix) {
+  for (int k = 0; k < matrix.outerSize(); k++) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(matrix, k); it; ++it) {
+      matrix_dense(it.row(), it.col()) = it.value();
+    }
+  }
+  lu.compute(matrix_dense);
+  status = (lu.matrixLU().diagonal().array() != 0.0).all()
+               ? Eigen::Success
+               : Eigen::NumericalIssue;
+}
+
+void DenseLUSolver::solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+                          Eigen::Matrix<double, Eigen::Dynamic, 1> &x) {
+  x.noalias() = lu.solve(rhs);
+}
+
+Eigen::ComputationInfo DenseLUSolver::info() const { return status; }
+
+/**
+ * @brief Find an augmenting path for the maximum transversal
+ *
+ * Depth-first search for an unmatched row that can be reached from a column
+ * by alternating between non-zero entries and matched entries.
+ *
+ * @param matrix Compressed matrix
+ * @param col Column to match
+ * @param col_of_row Column matched to each row (-1 if unmatched)
+ * @param visited Rows visited in the current search
+ * @return Whether the column could be matched
+ */
+static bool augment(const Eigen::SparseMatrix<double> &matrix, int col,
+                    std::vector<int> &col_of_row, std::vector<bool> &visited) {
+  for (int i = matrix.outerIndexPtr()[col];
+       i < matrix.outerIndexPtr()[col + 1]; i++) {
+    int row = matrix.innerIndexPtr()[i];
+    if (visited[row]) {
+      continue;
+    }
+    visited[row] = true;
+    if ((col_of_row[row] == -1) ||
+        augment(matrix, col_of_row[row], col_of_row, visited)) {
+      col_of_row[row] = col;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Strongly connected components (Tarjan's algorithm)
+ *
+ * Node j of the graph is the unknown of column j. There is an edge from j to
+ * k if the equation matched to unknown k depends on unknown j. The components
+ * are numbered such that the component of k is not larger than the component
+ * of j for every edge, i.e. ordering the unknowns by component gives a block
+ * upper triangular matrix.
+ */
+class StronglyConnectedComponents {
+ public:
+  /**
+   * @brief Compute the strongly connected components
+   *
+   * @param matrix Compressed matrix
+   * @param col_of_row Column matched to each row
+   */
+  StronglyConnectedComponents(const Eigen::SparseMatrix<double> &matrix,
+                              const std::vector<int> &col_of_row)
+      : matrix(matrix), col_of_row(col_of_row) {
+    int n = matrix.cols();
+    index.assign(n, -1);
+    lowlink.assign(n, 0);
+    on_stack.assign(n, false);
+    component.assign(n, -1);
+    for (int j = 0; j < n; j++) {
+      if (index[j] == -1) {
+        visit(j);
+      }
+    }
+  }
+
+  int num_components{0};       ///< Number of components
+  std::vector<int> component;  ///< Component of each unknown
+
+ private:
+  const Eigen::SparseMatrix<double> &matrix;  ///< Matrix
+  const std::vector<int> &col_of_row;  ///< Column matched to each row
+  std::vector<int> index;              ///< Visiting order of each node
+  std::vector<int> lowlink;     ///< Smallest index reachable from each node
+  std::vector<bool> on_stack;   ///< Whether a node is on the stack
+  std::vector<int> stack;       ///< Visited nodes without component
+  int counter{0};               ///< Number of visited nodes
+
+  /**
+   * @brief Depth-first search starting from a node
+   *
+   * @param j Node to visit
+   */
+  void visit(int j) {
+    index[j] = lowlink[j] = counter++;
+    stack.push_back(j);
+    on_stack[j] = true;
+    for (int i = matrix.outerIndexPtr()[j]; i < matrix.outerIndexPtr()[j + 1];
+         i++) {
+      int k = col_of_row[matrix.innerIndexPtr()[i]];
+      if (index[k] == -1) {
+        visit(k);
+        lowlink[j] = std::min(lowlink[j], lowlink[k]);
+      } else if (on_stack[k]) {
+        lowlink[j] = std::min(lowlink[j], index[k]);
+      }
+    }
+    if (lowlink[j] == index[j]) {
+      int k;
+      do {
+        k = stack.back();
+        stack.pop_back();
+        on_stack[k] = false;
+        component[k] = num_components;
+      } while (k != j);
+      num_components++;
+    }
+  }
+};
+
+void BTFLUSolver::analyze_pattern(const Eigen::SparseMatrix<double> &matrix) {
+  int n = matrix.cols();
+
+  // Maximum transversal: match each unknown with an equation (row) that
+  // depends on it
+  std::vector<int> col_of_row(n, -1);
+  std::vector<bool> visited(n);
+  structurally_singular = false;
+  for (int j = 0; j < n; j++) {
+    std::fill(visited.begin(), visited.end(), false);
+    if (!augment(matrix, j, col_of_row, visited)) {
+      structurally_singular = true;
+    }
+  }
+  if (structurally_singular) {
+    block_ptr.clear();
+    return;
+  }
+  row_of_col.resize(n);
+  for (int i = 0; i < n; i++) {
+    row_of_col[col_of_row[i]] = i;
+  }
+
+  // Blocks of the block upper triangular form
+  StronglyConnectedComponents components(matrix, col_of_row);
+  int num_blocks = components.num_components;
+  block_of_col = components.component;
+  block_ptr.assign(num_blocks + 1, 0);
+  for (int j = 0; j < n; j++) {
+    block_ptr[block_of_col[j] + 1]++;
+  }
+  for (int b = 0; b < num_blocks; b++) {
+    block_ptr[b + 1] += block_ptr[b];
+  }
+  block_cols.resize(n);
+  local_of_col.resize(n);
+  std::vector<int> block_fill(block_ptr.begin(), block_ptr.end() - 1);
+  for (int j = 0; j < n; j++) {
+    int b = block_of_col[j];
+    local_of_col[j] = block_fill[b] - block_ptr[b];
+    block_cols[block_fill[b]++] = j;
+  }
+
+  // Sort the entries into diagonal blocks and off-diagonal blocks. The row of
+  // an entry in the permuted matrix is the unknown matched to its equation.
+  std::vector<std::vector<int>> block_entries(num_blocks);
+  std::vector<std::vector<int>> block_entry_cols(num_blocks);
+  offdiag_ptr.assign(n + 1, 0);
+  offdiag_rows.clear();
+  offdiag_entries.clear();
+  for (int j = 0; j < n; j++) {
+    for (int i = matrix.outerIndexPtr()[j]; i < matrix.outerIndexPtr()[j + 1];
+         i++) {
+      int k = col_of_row[matrix.innerIndexPtr()[i]];
+      if (block_of_col[k] == block_of_col[j]) {
+        block_entries[block_of_col[j]].push_back(i);
+        block_entry_cols[block_of_col[j]].push_back(local_of_col[j]);
+      } else {
+        offdiag_rows.push_back(k);
+        offdiag_entries.push_back(i);
+      }
+    }
+    offdiag_ptr[j + 1] = offdiag_entries.size();
+  }
+  offdiag_values =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(offdiag_entries.size());
+
+  diag_ptr.assign(num_blocks + 1, 0);
+  diag_entries.clear();
+  diag_rows.clear();
+  diag_cols.clear();
+  block_matrices.resize(num_blocks);
+  block_lus.resize(num_blocks);
+  block_rhs.resize(num_blocks);
+  for (int b = 0; b < num_blocks; b++) {
+    for (size_t p = 0; p < block_entries[b].size(); p++) {
+      int i = block_entries[b][p];
+      diag_entries.push_back(i);
+      diag_rows.push_back(local_of_col[col_of_row[matrix.innerIndexPtr()[i]]]);
+      diag_cols.push_back(block_entry_cols[b][p]);
+    }
+    diag_ptr[b + 1] = diag_entries.size();
+    int size = block_ptr[b + 1] - block_ptr[b];
+    block_matrices[b] = Eigen::MatrixXd::Zero(size, size);
+    block_lus[b] = Eigen::PartialPivLU<Eigen::MatrixXd>(size);
+    block_rhs[b] = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(size);
+  }
+  work = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(n);
+}
+
+void BTFLUSolver::factorize(const Eigen::SparseMatrix<double> &matrix) {
+  status = Eigen::NumericalIssue;
+  if (structurally_singular) {
+    return;
+  }
+  auto values = matrix.valuePtr();
+  for (size_t p = 0; p < offdiag_entries.size(); p++) {
+    offdiag_values[p] = values[offdiag_entries[p]];
+  }
+  for (size_t b = 0; b < block_matrices.size(); b++) {
+    auto &block = block_matrices[b];
+    for (int p = diag_ptr[b]; p < diag_ptr[b + 1]; p++) {
+      block(diag_rows[p], diag_cols[p]) = values[diag_entries[p]];
+    }
+    if (block.rows() == 1) {
+      if (block(0, 0) == 0.0) {
+        return;
+      }
+    } else {
+      block_lus[b].compute(block);
+      if (!(block_lus[b].matrixLU().diagonal().array() != 0.0).all()) {
+        return;
+      }
+    }
+  }
+  status = Eigen::Success;
+}
+
+void BTFLUSolver::solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+                        Eigen::Matrix<double, Eigen::Dynamic, 1> &x) {
+  // Permute the equations such that equation j is matched to unknown j
+  int n = rhs.size();
+  for (int j = 0; j < n; j++) {
+    work[j] = rhs[row_of_col[j]];
+  }
+
+  // Block back substitution
+  for (int b = block_matrices.size() - 1; b >= 0; b--) {
+    if (block_matrices[b].rows() == 1) {
+      int j = block_cols[block_ptr[b]];
+      x[j] = work[j] / block_matrices[b](0, 0);
+    } else {
+      // Row permutation of the partial pivoting is applied in the gather
+      auto &block_x = block_rhs[b];
+      auto &perm = block_lus[b].permutationP().indices();
+      for (int p = block_ptr[b]; p < block_ptr[b + 1]; p++) {
+        block_x[perm[p - block_ptr[b]]] = work[block_cols[p]];
+      }
+      block_lus[b].matrixLU().triangularView<Eigen::UnitLower>().solveInPlace(
+          block_x);
+      block_lus[b].matrixLU().triangularView<Eigen::Upper>().solveInPlace(
+          block_x);
+      for (int p = block_ptr[b]; p < block_ptr[b + 1]; p++) {
+        x[block_cols[p]] = block_x[p - block_ptr[b]];
+      }
+    }
+    for (int p = block_ptr[b]; p < block_ptr[b + 1]; p++) {
+      int j = block_cols[p];
+      for (int i = offdiag_ptr[j]; i < offdiag_ptr[j + 1]; i++) {
+        work[offdiag_rows[i]] -= offdiag_values[i] * x[j];
+      }
+    }
+  }
+}
+
+Eigen::ComputationInfo BTFLUSolver::info() const { return status; }
+
+int BTFLUSolver::num_blocks() const {
+  return std::max(int(block_ptr.size()) - 1, 0);
+}
+
+int BTFLUSolver::max_block_size() const {
+  int max_size = 0;
+  for (int b = 0; b < num_blocks(); b++) {
+    max_size = std::max(max_size, block_ptr[b + 1] - block_ptr[b]);
+  }
+  return max_size;
+}
+
+std::shared_ptr<LinearSolver> create_linear_solver(
+    LinearSolverType type, const Eigen::SparseMatrix<double> &matrix) {
+  switch (type) {
+    case LinearSolverType::sparse_lu:
+      return std::make_shared<SparseLUSolver>();
+    case LinearSolverType::dense_lu:
+      return std::make_shared<DenseLUSolver>();
+    case LinearSolverType::btf_lu:
+      return std::make_shared<BTFLUSolver>();
+    default:
+      break;
+  }
+
+  // Automatic choice: The overhead of the sparse data structures dominates
+  // for small (diagonal blocks of) systems. Dense LU is only efficient for
+  // large systems if most entries are non-zero.
+  auto btf = std::make_shared<BTFLUSolver>();
+  btf->analyze_pattern(matrix);
+  double n = matrix.rows();
+  double fill = double(matrix.nonZeros()) / (n * n);
+  if ((btf->num_blocks() == 0) ||
+      ((btf->max_block_size() > 32) && (fill < 0.2))) {
+    return std::make_shared<SparseLUSolver>();
+  } else if (btf->num_blocks() == 1) {
+    return std::make_shared<DenseLUSolver>();
+  }
+  return btf;
+}
@@ -0,0 +1,232 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file LinearSolver.h
+ * @brief LinearSolver source file
+ */
+#ifndef SVZERODSOLVER_ALGEBRA_LINEARSOLVER_HPP_
+#define SVZERODSOLVER_ALGEBRA_LINEARSOLVER_HPP_
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Available linear solvers
+ */
+enum class LinearSolverType {
+  automatic = 0,  ///< Choose based on system size and sparsity
+  sparse_lu = 1,  ///< Supernodal sparse LU (Eigen::SparseLU)
+  dense_lu = 2,   ///< Dense LU with partial pivoting
+  btf_lu = 3      ///< Block triangular form with dense LU of diagonal blocks
+};
+
+/**
+ * @brief Linear solver for the jacobian of SparseSystem
+ *
+ * The sparsity pattern is analyzed once in analyze_pattern(). Afterwards,
+ * matrices with the same (compressed) sparsity pattern can be factorized and
+ * solved repeatedly. Neither factorize() (except for SparseLUSolver) nor
+ * solve() allocate memory.
+ */
+class LinearSolver {
+ public:
+  /**
+   * @brief Destroy the LinearSolver object
+   *
+   */
+  virtual ~LinearSolver() {}
+
+  /**
+   * @brief Analyze the sparsity pattern of the matrix
+   *
+   * @param matrix Compressed matrix
+   */
+  virtual void analyze_pattern(const Eigen::SparseMatrix<double> &matrix) = 0;
+
+  /**
+   * @brief Factorize the matrix
+   *
+   * @param matrix Compressed matrix with the analyzed sparsity pattern
+   */
+  virtual void factorize(const Eigen::SparseMatrix<double> &matrix) = 0;
+
+  /**
+   * @brief Solve with the last factorization
+   *
+   * @param rhs Right-hand side
+   * @param x Solution (must have the size of the system)
+   */
+  virtual void solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+                     Eigen::Matrix<double, Eigen::Dynamic, 1> &x) = 0;
+
+  /**
+   * @brief Get the status of the last factorization
+   *
+   * @return `Eigen::Success` if the factorization succeeded
+   */
+  virtual Eigen::ComputationInfo info() const = 0;
+};
+
+/**
+ * @brief Supernodal sparse LU factorization
+ *
+ * Uses `Eigen::SparseLU` for the factorization. The solve performs the same
+ * forward and backward substitution as `Eigen::SparseLU::solve` with
+ * preallocated work vectors.
+ */
+class SparseLUSolver : public LinearSolver {
+ public:
+  void analyze_pattern(const Eigen::SparseMatrix<double> &matrix);
+  void factorize(const Eigen::SparseMatrix<double> &matrix);
+  void solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+             Eigen::Matrix<double, Eigen::Dynamic, 1> &x);
+  Eigen::ComputationInfo info() const;
+
+ private:
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> lu;  ///< Factorization
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      buffer;  ///< Buffer for the permutation of the solution
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      work;  ///< Work vector of the forward substitution
+};
+
+/**
+ * @brief Dense LU factorization with partial pivoting
+ *
+ * Efficient for small systems where the overhead of the sparse data
+ * structures dominates.
+ */
+class DenseLUSolver : public LinearSolver {
+ public:
+  void analyze_pattern(const Eigen::SparseMatrix<double> &matrix);
+  void factorize(const Eigen::SparseMatrix<double> &matrix);
+  void solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+             Eigen::Matrix<double, Eigen::Dynamic, 1> &x);
+  Eigen::ComputationInfo info() const;
+
+ private:
+  Eigen::MatrixXd matrix_dense;               ///< Dense copy of the matrix
+  Eigen::PartialPivLU<Eigen::MatrixXd> lu;    ///< Factorization
+  Eigen::ComputationInfo status{Eigen::Success};  ///< Factorization status
+};
+
+/**
+ * @brief LU factorization in block triangular form
+ *
+ * In analyze_pattern(), the rows are permuted to obtain a zero-free diagonal
+ * (maximum transversal) and the strongly connected components of the graph of
+ * the permuted matrix are computed. Ordering the unknowns by component gives
+ * a block upper triangular matrix
+ *
+ * \f[
+ * \mathbf{P} \mathbf{A} \mathbf{Q} =
+ * \begin{bmatrix}
+ * \mathbf{A}_{11} & \mathbf{A}_{12} & \cdots \\
+ * & \mathbf{A}_{22} & \cdots \\
+ * & & \ddots
+ * \end{bmatrix}.
+ * \f]
+ *
+ * Only the diagonal blocks are factorized (with dense LU). The system is then
+ * solved by block back substitution with the off-diagonal blocks. This is
+ * efficient if a model decouples into many small blocks, e.g. boundary
+ * conditions with prescribed flow or pressure.
+ */
+class BTFLUSolver : public LinearSolver {
+ public:
+  void analyze_pattern(const Eigen::SparseMatrix<double> &matrix);
+  void factorize(const Eigen::SparseMatrix<double> &matrix);
+  void solve(const Eigen::Matrix<double, Eigen::Dynamic, 1> &rhs,
+             Eigen::Matrix<double, Eigen::Dynamic, 1> &x);
+  Eigen::ComputationInfo info() const;
+
+  /**
+   * @brief Get the number of diagonal blocks
+   *
+   * @return Number of diagonal blocks (0 if the matrix is structurally
+   * singular)
+   */
+  int num_blocks() const;
+
+  /**
+   * @brief Get the size of the largest diagonal block
+   *
+   * @return Size of the largest diagonal block
+   */
+  int max_block_size() const;
+
+ private:
+  bool structurally_singular{false};  ///< Whether there is no zero-free
+                                      ///< diagonal
+  Eigen::ComputationInfo status{Eigen::Success};  ///< Factorization status
+  std::vector<int> row_of_col;    ///< Row matched to the unknown of a column
+  std::vector<int> block_ptr;     ///< Start of each block in block_cols
+  std::vector<int> block_cols;    ///< Unknowns ordered by block
+  std::vector<int> block_of_col;  ///< Block of each unknown
+  std::vector<int> local_of_col;  ///< Position of each unknown in its block
+  std::vector<int> diag_entries;  ///< Value positions of block entries
+  std::vector<int> diag_ptr;      ///< Start of the entries of each block
+  std::vector<int> diag_rows;     ///< Local row of the block entries
+  std::vector<int> diag_cols;     ///< Local column of the block entries
+  std::vector<int> offdiag_ptr;   ///< Start of off-block entries of a column
+  std::vector<int> offdiag_rows;  ///< Permuted row of off-block entries
+  std::vector<int> offdiag_entries;  ///< Value positions of off-block
+                                     ///< entries
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      offdiag_values;  ///< Off-block values of the factorized matrix
+  std::vector<Eigen::MatrixXd> block_matrices;  ///< Diagonal blocks
+  std::vector<Eigen::PartialPivLU<Eigen::MatrixXd>>
+      block_lus;  ///< Factorizations of the diagonal blocks
+  std::vector<Eigen::Matrix<double, Eigen::Dynamic, 1>>
+      block_rhs;  ///< Work vectors of the diagonal blocks
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      work;  ///< Permuted right-hand side
+};
+
+/**
+ * @brief Create a linear solver for a matrix
+ *
+ * The automatic choice is based on the block triangular form of the matrix.
+ * If the diagonal blocks are small (at most 32 unknowns) or the matrix is
+ * dense (at least 20% non-zero entries), the diagonal blocks are factorized
+ * with dense LU (BTFLUSolver, or DenseLUSolver for a single block).
+ * Otherwise, a supernodal sparse LU is used.
+ *
+ * @param type Type of the linear solver
+ * @param matrix Compressed matrix (only the sparsity pattern is used)
+ * @return Linear solver (the pattern is not yet analyzed)
+ */
+std::shared_ptr<LinearSolver> create_linear_solver(
+    LinearSolverType type, const Eigen::SparseMatrix<double> &matrix);
+
+#endif  // SVZERODSOLVER_ALGEBRA_LINEARSOLVER_HPP_
@@ -30,11 +30,14 @@
 
 #include "SparseSystem.h"
 
+#include <algorithm>
+
 #include "Model.h"
 
 SparseSystem::SparseSystem() {}
 
-SparseSystem::SparseSystem(int n) {
+SparseSystem::SparseSystem(int n, LinearSolverType linear_solver_type) {
+  this->linear_solver_type = linear_solver_type;
   F = Eigen::SparseMatrix<double>(n, n);
   E = Eigen::SparseMatrix<double>(n, n);
   dC_dy = Eigen::SparseMatrix<double>(n, n);
@@ -55,6 +58,19 @@ void SparseSystem::clean() {
 }
 
 void SparseSystem::reserve(Model *model) {
+  this->model = model;
+  slots = model->get_slots();
+
+  // Reuse the pattern computed for another system of the model
+  auto pattern = model->get_system_pattern();
+  if (pattern && (pattern->size == residual.size()) &&
+      (pattern->linear_solver_type == linear_solver_type)) {
+    load_pattern(*pattern);
+    model->update_constant(*this);
+    model->update_time(*this, 0.0);
+    return;
+  }
+
   auto num_triplets = model->get_num_triplets();
   F.reserve(num_triplets.F);
   E.reserve(num_triplets.E);
@@ -62,6 +78,17 @@ void SparseSystem::reserve(Model *model) {
   dC_dydot.reserve(num_triplets.D);
 
   model->update_constant(*this);
+
+  // Make sure all registered entries exist before their positions are fixed
+  for (auto &slot : slots) {
+    get_matrix(slot.matrix).coeffRef(slot.row, slot.col);
+  }
+  F.makeCompressed();
+  E.makeCompressed();
+  dC_dy.makeCompressed();
+  dC_dydot.makeCompressed();
+  update_slot_positions();
+
   model->update_time(*this, 0.0);
 
   Eigen::Matrix<double, Eigen::Dynamic, 1> dummy_y =
@@ -72,14 +99,135 @@ void SparseSystem::reserve(Model *model) {
 
   model->update_solution(*this, dummy_y, dummy_dy);
 
+  update_jacobian_pattern();
+}
+
+bool SparseSystem::jacobian_pattern_is_valid() const {
+  return F.isCompressed() && E.isCompressed() && dC_dy.isCompressed() &&
+         dC_dydot.isCompressed() && (jacobian_map_F.size() == F.nonZeros()) &&
+         (jacobian_map_E.size() == E.nonZeros()) &&
+         (jacobian_map_dC_dy.size() == dC_dy.nonZeros()) &&
+         (jacobian_map_dC_dydot.size() == dC_dydot.nonZeros());
+}
+
+/**
+ * @brief Find the position of the non-zero entries of a matrix in the value
+ * array of another matrix that contains the same entries
+ *
+ * @param matrix Matrix with the non-zero entries to find
+ * @param target Matrix whose pattern contains the pattern of matrix
+ * @param map Positions in the value array of target
+ */
+static void map_entries(const Eigen::SparseMatrix<double> &matrix,
+                        const Eigen::SparseMatrix<double> &target,
+                        std::vector<int> &map) {
+  map.resize(matrix.nonZeros());
+  auto target_inner = target.innerIndexPtr();
+  for (int k = 0; k < matrix.outerSize(); k++) {
+    auto begin = target_inner + target.outerIndexPtr()[k];
+    auto end = target_inner + target.outerIndexPtr()[k + 1];
+    for (int i = matrix.outerIndexPtr()[k];
+         i < matrix.outerIndexPtr()[k + 1]; i++) {
+      map[i] = std::lower_bound(begin, end, matrix.innerIndexPtr()[i]) -
+               target_inner;
+    }
+  }
+}
+
+void SparseSystem::update_slot_positions() {
+  slot_positions.resize(slots.size());
+  for (size_t i = 0; i < slots.size(); i++) {
+    auto &matrix = get_matrix(slots[i].matrix);
+    auto begin = matrix.innerIndexPtr() + matrix.outerIndexPtr()[slots[i].col];
+    auto end =
+        matrix.innerIndexPtr() + matrix.outerIndexPtr()[slots[i].col + 1];
+    slot_positions[i] =
+        std::lower_bound(begin, end, slots[i].row) - matrix.innerIndexPtr();
+  }
+}
+
+void SparseSystem::update_jacobian_pattern() {
   F.makeCompressed();
   E.makeCompressed();
   dC_dy.makeCompressed();
   dC_dydot.makeCompressed();
-  jacobian.reserve(num_triplets.F + num_triplets.E);  // Just an estimate
-  update_jacobian(1.0, 1.0);  // Update it once to have sparsity pattern
+
+  // Union of the sparsity patterns of all system matrices
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(F.nonZeros() + E.nonZeros() + dC_dy.nonZeros() +
+                   dC_dydot.nonZeros());
+  for (auto matrix : {&F, &E, &dC_dy, &dC_dydot}) {
+    for (int k = 0; k < matrix->outerSize(); k++) {
+      for (Eigen::SparseMatrix<double>::InnerIterator it(*matrix, k); it;
+           ++it) {
+        triplets.push_back({(int)it.row(), (int)it.col(), 0.0});
+      }
+    }
+  }
+  jacobian.setFromTriplets(triplets.begin(), triplets.end());
   jacobian.makeCompressed();
-  solver->analyzePattern(jacobian);  // Let solver analyze pattern
+
+  update_slot_positions();
+
+  map_entries(F, jacobian, jacobian_map_F);
+  map_entries(E, jacobian, jacobian_map_E);
+  map_entries(dC_dy, jacobian, jacobian_map_dC_dy);
+  map_entries(dC_dydot, jacobian, jacobian_map_dC_dydot);
+
+  jacobian_values_ydot =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(jacobian.nonZeros());
+  jacobian_values_y =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(jacobian.nonZeros());
+
+  // Let a new solver analyze the pattern (systems that still use the previous
+  // pattern keep the previous solver)
+  solver = create_linear_solver(linear_solver_type, jacobian);
+  solver->analyze_pattern(jacobian);
+  factorized_jacobian_values =
+      std::make_shared<Eigen::Matrix<double, Eigen::Dynamic, 1>>();
+
+  // Share the pattern with all systems created for the model from now on
+  auto pattern = std::make_shared<SystemPattern>();
+  pattern->size = residual.size();
+  pattern->linear_solver_type = linear_solver_type;
+  pattern->F = F;
+  pattern->E = E;
+  pattern->dC_dy = dC_dy;
+  pattern->dC_dydot = dC_dydot;
+  pattern->jacobian = jacobian;
+  pattern->slot_positions = slot_positions;
+  pattern->jacobian_map_F = jacobian_map_F;
+  pattern->jacobian_map_E = jacobian_map_E;
+  pattern->jacobian_map_dC_dy = jacobian_map_dC_dy;
+  pattern->jacobian_map_dC_dydot = jacobian_map_dC_dydot;
+  pattern->solver = solver;
+  pattern->factorized_jacobian_values = factorized_jacobian_values;
+  model->set_system_pattern(pattern);
+}
+
+void SparseSystem::load_pattern(const SystemPattern &pattern) {
+  F = pattern.F;
+  E = pattern.E;
+  dC_dy = pattern.dC_dy;
+  dC_dydot = pattern.dC_dydot;
+  for (auto matrix : {&F, &E, &dC_dy, &dC_dydot}) {
+    matrix->coeffs().setZero();
+  }
+  jacobian = pattern.jacobian;
+  slot_positions = pattern.slot_positions;
+  jacobian_map_F = pattern.jacobian_map_F;
+  jacobian_map_E = pattern.jacobian_map_E;
+  jacobian_map_dC_dy = pattern.jacobian_map_dC_dy;
+  jacobian_map_dC_dydot = pattern.jacobian_map_dC_dydot;
+  jacobian_values_ydot =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(jacobian.nonZeros());
+  jacobian_values_y =
+      Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(jacobian.nonZeros());
+
+  // The factorization is shared as well. It is only reused if the values of
+  // the jacobian match the factorized ones.
+  solver = pattern.solver;
+  factorized_jacobian_values = pattern.factorized_jacobian_values;
 }
 
 void SparseSystem::update_residual(
@@ -93,13 +241,48 @@ void SparseSystem::update_residual(
 
 void SparseSystem::update_jacobian(double time_coeff_ydot,
                                    double time_coeff_y) {
-  jacobian.setZero();
-  jacobian += (E + dC_dydot) * time_coeff_ydot;
-  jacobian += (F + dC_dy) * time_coeff_y;
+  // Elements may have added new entries since the pattern was computed
+  if (!jacobian_pattern_is_valid()) {
+    update_jacobian_pattern();
+  }
+
+  jacobian_values_ydot.setZero();
+  jacobian_values_y.setZero();
+  for (size_t i = 0; i < jacobian_map_E.size(); i++) {
+    jacobian_values_ydot[jacobian_map_E[i]] += E.valuePtr()[i];
+  }
+  for (size_t i = 0; i < jacobian_map_dC_dydot.size(); i++) {
+    jacobian_values_ydot[jacobian_map_dC_dydot[i]] += dC_dydot.valuePtr()[i];
+  }
+  for (size_t i = 0; i < jacobian_map_F.size(); i++) {
+    jacobian_values_y[jacobian_map_F[i]] += F.valuePtr()[i];
+  }
+  for (size_t i = 0; i < jacobian_map_dC_dy.size(); i++) {
+    jacobian_values_y[jacobian_map_dC_dy[i]] += dC_dy.valuePtr()[i];
+  }
+
+  Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 1>>(jacobian.valuePtr(),
+                                                       jacobian.nonZeros()) =
+      jacobian_values_ydot * time_coeff_ydot +
+      jacobian_values_y * time_coeff_y;
 }
 
-void SparseSystem::solve() {
+void SparseSystem::factorize() {
   solver->factorize(jacobian);
-  dydot.setZero();
-  dydot += solver->solve(residual);
+  *factorized_jacobian_values =
+      Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 1>>(jacobian.valuePtr(),
+                                                           jacobian.nonZeros());
+}
+
+bool SparseSystem::is_factorized() const {
+  return factorized_jacobian_values->size() == jacobian.nonZeros();
+}
+
+bool SparseSystem::jacobian_is_factorized() const {
+  return is_factorized() &&
+         (Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 1>>(
+              jacobian.valuePtr(), jacobian.nonZeros()) ==
+          *factorized_jacobian_values);
 }
+
+void SparseSystem::solve() { solver->solve(residual, dydot); }
@@ -35,13 +35,66 @@
 #define SVZERODSOLVER_ALGREBRA_SPARSESYSTEM_HPP_
 
 #include <Eigen/Sparse>
-#include <Eigen/SparseLU>
 #include <iostream>
 #include <memory>
+#include <vector>
+
+#include "LinearSolver.h"
 
 // Forward declaration of Model
 class Model;
 
+/**
+ * @brief System matrices that element contributions are assembled into
+ */
+enum class SystemMatrix { F = 0, E = 1, dC_dy = 2, dC_dydot = 3 };
+
+/**
+ * @brief Entry of a system matrix that is updated repeatedly
+ *
+ * Blocks register the entries they update in every time step or nonlinear
+ * iteration as slots (see Block::register_slot). The position of each slot in
+ * the value array of the system matrix is resolved once in
+ * SparseSystem::reserve.
+ */
+struct SystemSlot {
+  SystemMatrix matrix;  ///< System matrix of the entry
+  int row;              ///< Row of the entry
+  int col;              ///< Column of the entry
+};
+
+/**
+ * @brief Symbolic data of a sparse system that only depends on the model
+ *
+ * Computing the sparsity patterns and analyzing the jacobian is expensive
+ * compared to a time step of a small model. The pattern is therefore computed
+ * once per model and shared by all systems created for it (see
+ * Model::get_system_pattern), e.g. by the integrators created in every call of
+ * the 3D coupling interface.
+ */
+struct SystemPattern {
+  int size{0};  ///< Size of the system
+  LinearSolverType linear_solver_type{
+      LinearSolverType::automatic};       ///< Type of the linear solver
+  Eigen::SparseMatrix<double> F;         ///< Pattern of system matrix F
+  Eigen::SparseMatrix<double> E;         ///< Pattern of system matrix E
+  Eigen::SparseMatrix<double> dC_dy;     ///< Pattern of system matrix dC/dy
+  Eigen::SparseMatrix<double> dC_dydot;  ///< Pattern of system matrix dC/dydot
+  Eigen::SparseMatrix<double> jacobian;  ///< Pattern of the jacobian
+  std::vector<int> slot_positions;       ///< Position of the registered
+                                         ///< entries in the value arrays
+  std::vector<int> jacobian_map_F;         ///< Position of F entries in K
+  std::vector<int> jacobian_map_E;         ///< Position of E entries in K
+  std::vector<int> jacobian_map_dC_dy;     ///< Position of dC/dy entries in K
+  std::vector<int> jacobian_map_dC_dydot;  ///< Position of dC/dydot entries
+                                           ///< in K
+  std::shared_ptr<LinearSolver> solver;  ///< Linear solver with the analyzed
+                                         ///< pattern of the jacobian
+  std::shared_ptr<Eigen::Matrix<double, Eigen::Dynamic, 1>>
+      factorized_jacobian_values;  ///< Values of the jacobian in the last
+                                   ///< factorization of the solver
+};
+
 /**
  * @brief Sparse system
  *
@@ -84,6 +137,16 @@ class Model;
  *
  * with time factors \f$c_{\dot{\mathbf{y}}}=\alpha_m\f$ and
  * \f$c_{\mathbf{y}}=\alpha_f\gamma\Delta t\f$ provided by Integrator.
+ *
+ * The sparsity pattern of \f$\mathbf{K}\f$ is the union of the patterns of
+ * the four system matrices. It is computed once in reserve(), together with
+ * the position of every non-zero entry of the system matrices in the value
+ * array of \f$\mathbf{K}\f$. The assembly in update_jacobian() is then a
+ * single pass over the stored values without any memory allocation.
+ *
+ * The patterns, the position maps and the analyzed linear solver are stored
+ * in a SystemPattern of the model and reused by every other system created
+ * for the same model. Only the numerical values are assembled per system.
  */
 class SparseSystem {
  public:
@@ -97,8 +160,11 @@ class SparseSystem {
    * @brief Construct a new Sparse System object
    *
    * @param n Size of the system
+   * @param linear_solver_type Type of the linear solver
    */
-  SparseSystem(int n);
+  SparseSystem(int n,
+               LinearSolverType linear_solver_type =
+                   LinearSolverType::automatic);
 
   /**
    * @brief Destroy the Sparse System object
@@ -118,14 +184,15 @@ class SparseSystem {
   Eigen::Matrix<double, Eigen::Dynamic, 1>
       dydot;  ///< Solution increment of the system
 
-  std::shared_ptr<Eigen::SparseLU<Eigen::SparseMatrix<double>>> solver =
-      std::shared_ptr<Eigen::SparseLU<Eigen::SparseMatrix<double>>>(
-          new Eigen::SparseLU<Eigen::SparseMatrix<double>>());  ///< Linear
-                                                                ///< solver
+  std::shared_ptr<LinearSolver> solver;  ///< Linear solver (created for the
+                                        ///< sparsity pattern of the jacobian)
 
   /**
    * @brief Reserve memory in system matrices based on number of triplets
    *
+   * Uses the cached pattern of the model if available. Otherwise, the pattern
+   * is computed and stored in the model.
+   *
    * @param model The model to reserve space for in the system
    */
   void reserve(Model *model);
@@ -148,15 +215,135 @@ class SparseSystem {
   void update_jacobian(double time_coeff_ydot, double time_coeff_y);
 
   /**
-   * @brief Solve the system
+   * @brief Factorize the jacobian of the system
+   */
+  void factorize();
+
+  /**
+   * @brief Check if a factorization of the jacobian is available
+   *
+   * @return Whether the linear solver holds a factorization of the jacobian
+   * (possibly of an outdated jacobian)
+   */
+  bool is_factorized() const;
+
+  /**
+   * @brief Check if the current jacobian is the one that was last factorized
+   *
+   * The values are compared exactly. This is the case for linear models where
+   * the jacobian only depends on the time step size.
+   *
+   * @return Whether the factorization of the current jacobian is available
+   */
+  bool jacobian_is_factorized() const;
+
+  /**
+   * @brief Solve the system with the last factorization of the jacobian
+   *
+   * The solution is computed without any memory allocation.
    */
   void solve();
 
   /**
    * @brief Delete dynamically allocated memory (class member
-   * Eigen::SparseLU<Eigen::SparseMatrix> *solver)
+   * LinearSolver *solver)
    */
   void clean();
+
+  /**
+   * @brief Get a registered entry of the system matrices
+   *
+   * Other than `coeffRef`, this does not search for the entry in the sparse
+   * matrix but uses its position in the value array computed in reserve().
+   *
+   * @param slot_id Global ID of the slot
+   * @return Reference to the value of the entry
+   */
+  inline double &slot(int slot_id) {
+    return get_matrix(slots[slot_id].matrix)
+        .valuePtr()[slot_positions[slot_id]];
+  }
+
+  /**
+   * @brief Get a system matrix
+   *
+   * @param matrix Identifier of the system matrix
+   * @return The system matrix
+   */
+  inline Eigen::SparseMatrix<double> &get_matrix(SystemMatrix matrix) {
+    switch (matrix) {
+      case SystemMatrix::F:
+        return F;
+      case SystemMatrix::E:
+        return E;
+      case SystemMatrix::dC_dy:
+        return dC_dy;
+      default:
+        return dC_dydot;
+    }
+  }
+
+ private:
+  std::vector<SystemSlot> slots;  ///< Registered entries of the model
+  std::vector<int> slot_positions;  ///< Position of the registered entries in
+                                    ///< the value arrays
+  std::vector<int> jacobian_map_F;         ///< Position of F entries in K
+  std::vector<int> jacobian_map_E;         ///< Position of E entries in K
+  std::vector<int> jacobian_map_dC_dy;     ///< Position of dC/dy entries in K
+  std::vector<int> jacobian_map_dC_dydot;  ///< Position of dC/dydot entries
+                                           ///< in K
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      jacobian_values_ydot;  ///< ydot-dependent part of the values of K
+  Eigen::Matrix<double, Eigen::Dynamic, 1>
+      jacobian_values_y;  ///< y-dependent part of the values of K
+  LinearSolverType linear_solver_type{
+      LinearSolverType::automatic};  ///< Type of the linear solver
+  Model *model{nullptr};             ///< Model that stores the pattern
+
+  /**
+   * @brief Values of the jacobian in the last factorization
+   *
+   * Shared between copies of the system like the linear solver itself.
+   */
+  std::shared_ptr<Eigen::Matrix<double, Eigen::Dynamic, 1>>
+      factorized_jacobian_values =
+          std::make_shared<Eigen::Matrix<double, Eigen::Dynamic, 1>>();
+
+  /**
+   * @brief Check if the jacobian pattern is consistent with the system
+   * matrices
+   *
+   * Elements may add new non-zero entries to the system matrices after the
+   * pattern was computed (which decompresses the matrix).
+   *
+   * @return Whether the stored jacobian pattern is still valid
+   */
+  bool jacobian_pattern_is_valid() const;
+
+  /**
+   * @brief Compute the sparsity pattern of the jacobian
+   *
+   * Compresses the system matrices, sets the jacobian to the union of their
+   * sparsity patterns and stores the position of each non-zero entry of the
+   * system matrices in the value array of the jacobian. The new pattern
+   * replaces the cached pattern of the model.
+   */
+  void update_jacobian_pattern();
+
+  /**
+   * @brief Set the system matrices and the jacobian to a cached pattern
+   *
+   * All values of the system matrices are set to zero.
+   *
+   * @param pattern The cached pattern
+   */
+  void load_pattern(const SystemPattern &pattern);
+
+  /**
+   * @brief Compute the position of the registered entries in the value arrays
+   * of the compressed system matrices
+   */
+  void update_slot_positions();
 };
 
 #endif  // SVZERODSOLVER_ALGREBRA_SPARSESYSTEM_HPP_
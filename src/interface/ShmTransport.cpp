@@ -0,0 +1,394 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "ShmTransport.h"
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <thread>
+
+// Functions of the interface library (see interface.cpp)
+
+extern "C" void initialize(std::string input_file, int& problem_id,
+                           int& pts_per_cycle, int& num_cycles,
+                           int& num_output_steps,
+                           std::vector<std::string>& block_names,
+                           std::vector<std::string>& variable_names);
+
+extern "C" int finalize(int problem_id);
+
+extern "C" void set_external_step_size(int problem_id,
+                                       double external_step_size);
+
+extern "C" void update_block_params(int problem_id, std::string block_name,
+                                    std::vector<double>& params);
+
+extern "C" void get_block_node_IDs(int problem_id, std::string block_name,
+                                   std::vector<int>& IDs);
+
+extern "C" int get_state_data(int problem_id, double** y, double** ydot,
+                              int* system_size);
+
+extern "C" int get_trial_state_data(int problem_id, double** y, double** ydot,
+                                    int* system_size);
+
+extern "C" int increment_time_data(int problem_id, const double external_time,
+                                   double* solution, int system_size);
+
+extern "C" int increment_time_trial(int problem_id, const double external_time);
+
+extern "C" int commit_time_step(int problem_id);
+
+/**
+ * @brief Identifies an svZeroD shared-memory segment
+ */
+static constexpr uint32_t shm_magic = 0x30445A53;
+
+/**
+ * @brief Hint to the processor that the thread is spinning
+ */
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Wait until a counter in shared memory differs from a value
+ *
+ * @param counter The counter
+ * @param value The value
+ * @param waiters Number of sleeping waiters
+ * @param num_spins Number of checks before sleeping
+ */
+static void wait_while_equal(std::atomic<uint32_t>& counter, uint32_t value,
+                             std::atomic<uint32_t>& waiters, int num_spins) {
+  for (int i = 0; i < num_spins; i++) {
+    if (counter.load(std::memory_order_acquire) != value) {
+      return;
+    }
+    cpu_relax();
+  }
+  // The other side checks for waiters after changing the counter
+  waiters.fetch_add(1);
+  while (counter.load() == value) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&counter), FUTEX_WAIT,
+            value, nullptr, nullptr, 0);
+  }
+  waiters.fetch_sub(1);
+}
+
+/**
+ * @brief Increment a counter in shared memory and wake up sleeping waiters
+ *
+ * @param counter The counter
+ * @param waiters Number of sleeping waiters
+ */
+static void increment_and_wake(std::atomic<uint32_t>& counter,
+                               std::atomic<uint32_t>& waiters) {
+  counter.fetch_add(1);
+  if (waiters.load() > 0) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&counter), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+  }
+}
+
+ShmMessage& ShmRing::wait_write(int num_spins) {
+  uint32_t position = head.load(std::memory_order_relaxed);
+  uint32_t released = tail.load(std::memory_order_acquire);
+  while (position - released >= shm_ring_size) {
+    wait_while_equal(tail, released, waiters, num_spins);
+    released = tail.load(std::memory_order_acquire);
+  }
+  return messages[position % shm_ring_size];
+}
+
+void ShmRing::publish() { increment_and_wake(head, waiters); }
+
+const ShmMessage& ShmRing::wait_read(int num_spins) {
+  uint32_t position = tail.load(std::memory_order_relaxed);
+  while (head.load(std::memory_order_acquire) == position) {
+    wait_while_equal(head, position, waiters, num_spins);
+  }
+  return messages[position % shm_ring_size];
+}
+
+void ShmRing::release() { increment_and_wake(tail, waiters); }
+
+ShmChannel::ShmChannel(const std::string& name, ShmSegment* segment,
+                       bool owner)
+    : segment(segment), name(name), owner(owner) {
+  if (std::thread::hardware_concurrency() > 1) {
+    num_spins = 4000;
+  }
+}
+
+ShmChannel::ShmChannel(ShmChannel&& other)
+    : segment(other.segment),
+      num_spins(other.num_spins),
+      name(std::move(other.name)),
+      owner(other.owner) {
+  other.segment = nullptr;
+  other.owner = false;
+}
+
+ShmChannel::~ShmChannel() {
+  if (segment != nullptr) {
+    munmap(segment, sizeof(ShmSegment));
+  }
+  if (owner) {
+    shm_unlink(name.c_str());
+  }
+}
+
+ShmChannel ShmChannel::create(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    throw std::runtime_error("Could not create shared-memory segment " + name +
+                             ": " + std::strerror(errno));
+  }
+  if (ftruncate(fd, sizeof(ShmSegment)) == -1) {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::runtime_error("Could not resize shared-memory segment " + name);
+  }
+  void* address = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw std::runtime_error("Could not map shared-memory segment " + name);
+  }
+
+  // The new segment is filled with zeros, which is a valid initial state of
+  // all counters
+  auto segment = static_cast<ShmSegment*>(address);
+  segment->magic = shm_magic;
+  return ShmChannel(name, segment, true);
+}
+
+ShmChannel ShmChannel::open(const std::string& name, double timeout) {
+  auto start = std::chrono::steady_clock::now();
+  auto timed_out = [&]() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+               .count() > timeout;
+  };
+
+  // Wait for the server to create the segment
+  int fd = -1;
+  struct stat status;
+  while (true) {
+    if (fd == -1) {
+      fd = shm_open(name.c_str(), O_RDWR, 0);
+    }
+    if ((fd != -1) && (fstat(fd, &status) == 0) &&
+        (status.st_size == sizeof(ShmSegment))) {
+      break;
+    }
+    if (timed_out()) {
+      if (fd != -1) {
+        close(fd);
+      }
+      throw std::runtime_error("Could not open shared-memory segment " + name);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  void* address = mmap(nullptr, sizeof(ShmSegment), PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    throw std::runtime_error("Could not map shared-memory segment " + name);
+  }
+  ShmChannel channel(name, static_cast<ShmSegment*>(address), false);
+
+  // Wait for the server to set up the segment
+  while (channel.segment->ready.load(std::memory_order_acquire) == 0) {
+    if (timed_out()) {
+      throw std::runtime_error("Shared-memory server " + name +
+                               " did not start");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (channel.segment->magic != shm_magic) {
+    throw std::runtime_error(name + " is not an svZeroD shared-memory segment");
+  }
+  return channel;
+}
+
+void ShmChannel::set_ready() {
+  segment->ready.store(1, std::memory_order_release);
+}
+
+int ShmChannel::request(ShmCommand command, double time, const double* values,
+                        double* response_values) {
+  int num_blocks = segment->num_blocks;
+  auto& request = segment->requests.wait_write(num_spins);
+  request.command = command;
+  request.time = time;
+  if (values != nullptr) {
+    std::copy_n(values, num_blocks, request.values);
+  }
+  segment->requests.publish();
+
+  auto& response = segment->responses.wait_read(num_spins);
+  int status = response.status;
+  if (response_values != nullptr) {
+    std::copy_n(response.values, num_blocks, response_values);
+  }
+  segment->responses.release();
+  return status;
+}
+
+ShmServer::ShmServer(const std::string& input_file_name) {
+  // Coupling blocks of the configuration
+  std::ifstream input_file(input_file_name);
+  const auto config = nlohmann::json::parse(input_file);
+  for (const auto& coupling_config :
+       config.value("external_solver_coupling_blocks", nlohmann::json::array())) {
+    block_names.push_back(coupling_config["name"]);
+    block_is_flow.push_back(coupling_config["type"] == "FLOW");
+  }
+  if (block_names.size() > shm_max_blocks) {
+    throw std::runtime_error("Too many coupling blocks for shared memory");
+  }
+
+  int pts_per_cycle = 0;
+  int num_cycles = 0;
+  int num_output_steps = 0;
+  std::vector<std::string> all_block_names;
+  std::vector<std::string> variable_names;
+  initialize(input_file_name, problem_id, pts_per_cycle, num_cycles,
+             num_output_steps, all_block_names, variable_names);
+  double* ydot = nullptr;
+  get_state_data(problem_id, &y, &ydot, &system_size);
+  get_trial_state_data(problem_id, &y_trial, &ydot, &system_size);
+
+  // The response of a block is the pressure of a FLOW block and the flow of
+  // a PRESSURE block at the node of the block
+  for (size_t i = 0; i < block_names.size(); i++) {
+    std::vector<int> IDs;
+    get_block_node_IDs(problem_id, block_names[i], IDs);
+    int node_offset = (IDs[0] > 0) ? 1 : 2;
+    response_ids.push_back(IDs[node_offset + (block_is_flow[i] ? 1 : 0)]);
+  }
+  params = {2.0, 0.0, 1.0, 0.0, 0.0};
+}
+
+ShmServer::~ShmServer() { finalize(problem_id); }
+
+void ShmServer::describe(ShmSegment& segment) const {
+  segment.num_blocks = block_names.size();
+  segment.system_size = system_size;
+  for (size_t i = 0; i < block_names.size(); i++) {
+    if (block_names[i].size() >= shm_max_name_length) {
+      throw std::runtime_error("Name of coupling block " + block_names[i] +
+                               " is too long for shared memory");
+    }
+    std::strcpy(segment.block_names[i], block_names[i].c_str());
+    segment.block_is_flow[i] = block_is_flow[i];
+  }
+}
+
+void ShmServer::handle(const ShmMessage& request, ShmMessage& response) {
+  response.command = request.command;
+  response.time = request.time;
+  response.status = 0;
+  int num_blocks = block_names.size();
+  try {
+    switch (request.command) {
+      case ShmCommand::set_external_step_size:
+        set_external_step_size(problem_id, request.values[0]);
+        break;
+
+      case ShmCommand::step:
+      case ShmCommand::trial: {
+        // Boundary values are constant during the time step
+        for (int i = 0; i < num_blocks; i++) {
+          params[3] = request.values[i];
+          params[4] = request.values[i];
+          update_block_params(problem_id, block_names[i], params);
+        }
+        bool trial = request.command == ShmCommand::trial;
+        response.status =
+            trial ? increment_time_trial(problem_id, request.time)
+                  : increment_time_data(problem_id, request.time, nullptr, 0);
+        double* state = trial ? y_trial : y;
+        for (int i = 0; i < num_blocks; i++) {
+          response.values[i] = state[response_ids[i]];
+        }
+        break;
+      }
+
+      case ShmCommand::commit:
+        response.status = commit_time_step(problem_id);
+        for (int i = 0; i < num_blocks; i++) {
+          response.values[i] = y[response_ids[i]];
+        }
+        break;
+
+      case ShmCommand::shutdown:
+        break;
+
+      default:
+        response.status = 1;
+    }
+  } catch (const std::runtime_error&) {
+    response.status = 1;
+  }
+}
+
+void ShmServer::serve(ShmChannel& channel) {
+  auto& requests = channel.segment->requests;
+  auto& responses = channel.segment->responses;
+  while (true) {
+    auto& request = requests.wait_read(channel.num_spins);
+    auto& response = responses.wait_write(channel.num_spins);
+    handle(request, response);
+    bool shutdown = request.command == ShmCommand::shutdown;
+    requests.release();
+    responses.publish();
+    if (shutdown) {
+      return;
+    }
+  }
+}
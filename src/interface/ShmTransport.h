@@ -0,0 +1,263 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file ShmTransport.h
+ * @brief ShmTransport source file
+ */
+#ifndef SVZERODSOLVER_INTERFACE_SHMTRANSPORT_HPP_
+#define SVZERODSOLVER_INTERFACE_SHMTRANSPORT_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Maximum number of coupling blocks exchanged through shared memory
+ */
+constexpr int shm_max_blocks = 256;
+
+/**
+ * @brief Maximum length of the name of a coupling block (including the
+ * terminating null character)
+ */
+constexpr int shm_max_name_length = 64;
+
+/**
+ * @brief Number of messages in each ring buffer
+ */
+constexpr int shm_ring_size = 16;
+
+/**
+ * @brief Commands of requests to the shared-memory server
+ */
+enum class ShmCommand : int32_t {
+  set_external_step_size = 0,  ///< Set the time step size (`values[0]`)
+  step = 1,      ///< Time step with the boundary values of the coupling blocks
+  trial = 2,     ///< Trial time step (see increment_time_trial())
+  commit = 3,    ///< Commit the last trial time step
+  shutdown = 4,  ///< Stop the server
+};
+
+/**
+ * @brief Message in a ring buffer
+ *
+ * Requests of time steps hold the boundary value of each coupling block
+ * (flow of FLOW blocks and pressure of PRESSURE blocks). Their responses hold
+ * the complementary quantity at the end of the time step (pressure of FLOW
+ * blocks and flow of PRESSURE blocks).
+ */
+struct ShmMessage {
+  ShmCommand command;            ///< Command of the request
+  int32_t status;                ///< Return code of the request (0: success)
+  double time;                   ///< Current time of the external program
+  double values[shm_max_blocks];  ///< Values of the coupling blocks
+};
+
+/**
+ * @brief Single-producer single-consumer ring buffer of messages
+ *
+ * The producer fills the message at `head` and publishes it by incrementing
+ * `head`, the consumer releases the message at `tail` by incrementing `tail`.
+ * Both counters are also used as futex words: A waiting side spins for a
+ * while and then sleeps in the kernel until the counter changes. The other
+ * side only issues a wake-up system call if a waiter is registered.
+ */
+struct ShmRing {
+  alignas(64) std::atomic<uint32_t> head;  ///< Number of published messages
+  alignas(64) std::atomic<uint32_t> tail;  ///< Number of released messages
+  alignas(64) std::atomic<uint32_t> waiters;  ///< Number of sleeping waiters
+  alignas(64) ShmMessage messages[shm_ring_size];  ///< Messages
+
+  /**
+   * @brief Wait for a free message
+   *
+   * @param num_spins Number of checks before sleeping
+   * @return Message to fill before publish()
+   */
+  ShmMessage& wait_write(int num_spins);
+
+  /**
+   * @brief Publish the message returned by wait_write()
+   */
+  void publish();
+
+  /**
+   * @brief Wait for a published message
+   *
+   * @param num_spins Number of checks before sleeping
+   * @return Message to read before release()
+   */
+  const ShmMessage& wait_read(int num_spins);
+
+  /**
+   * @brief Release the message returned by wait_read()
+   */
+  void release();
+};
+
+/**
+ * @brief Layout of the shared-memory segment
+ */
+struct ShmSegment {
+  uint32_t magic;                 ///< Identifies an svZeroD segment
+  std::atomic<uint32_t> ready;    ///< Set when the server is ready
+  int32_t num_blocks;             ///< Number of coupling blocks
+  int32_t system_size;            ///< Size of the 0D system
+  int32_t block_is_flow[shm_max_blocks];  ///< Whether each coupling block
+                                          ///< prescribes a flow
+  char block_names[shm_max_blocks]
+                  [shm_max_name_length];  ///< Names of the coupling blocks
+  ShmRing requests;                       ///< Requests of the client
+  ShmRing responses;                      ///< Responses of the server
+};
+
+/**
+ * @brief Mapping of a POSIX shared-memory segment for coupling svZeroD with
+ * an external program in another process
+ *
+ * The server process creates the segment and the client (e.g. a 3D solver)
+ * opens it by name. Each side is expected to be single-threaded with respect
+ * to the segment.
+ */
+class ShmChannel {
+ public:
+  /**
+   * @brief Create a new segment (server)
+   *
+   * @param name Name of the segment (e.g. "/svzerod")
+   */
+  static ShmChannel create(const std::string& name);
+
+  /**
+   * @brief Open the segment of a server (client)
+   *
+   * Waits until the server created the segment and set it up.
+   *
+   * @param name Name of the segment
+   * @param timeout Maximum waiting time in seconds
+   */
+  static ShmChannel open(const std::string& name, double timeout);
+
+  ShmChannel(ShmChannel&& other);
+  ShmChannel(const ShmChannel&) = delete;
+  ShmChannel& operator=(const ShmChannel&) = delete;
+
+  /**
+   * @brief Unmap the segment (the server also removes the segment)
+   */
+  ~ShmChannel();
+
+  /**
+   * @brief Mark the segment as set up (server)
+   */
+  void set_ready();
+
+  /**
+   * @brief Send a request and wait for the response (client)
+   *
+   * @param command Command of the request
+   * @param time Current time of the external program
+   * @param values Values of the coupling blocks (can be nullptr)
+   * @param response_values Array for the values of the response (can be
+   * nullptr)
+   * @return Return code of the request
+   */
+  int request(ShmCommand command, double time, const double* values,
+              double* response_values);
+
+  ShmSegment* segment = nullptr;  ///< Mapped segment
+  int num_spins = 0;  ///< Number of checks before sleeping (no spinning on a
+                      ///< single core)
+
+ private:
+  ShmChannel(const std::string& name, ShmSegment* segment, bool owner);
+
+  std::string name;    ///< Name of the segment
+  bool owner = false;  ///< Whether the segment was created by this channel
+};
+
+/**
+ * @brief Server that runs a 0D model for requests through shared memory
+ *
+ * The model is set up and stepped with the functions of the interface
+ * library. Coupling blocks are taken from `external_solver_coupling_blocks`
+ * of the configuration.
+ */
+class ShmServer {
+ public:
+  /**
+   * @brief Set up the 0D model
+   *
+   * @param input_file_name The 0D JSON file which specifies the model
+   */
+  ShmServer(const std::string& input_file_name);
+
+  /**
+   * @brief Delete the 0D model
+   */
+  ~ShmServer();
+
+  /**
+   * @brief Describe the coupling blocks in a segment
+   *
+   * @param segment The segment
+   */
+  void describe(ShmSegment& segment) const;
+
+  /**
+   * @brief Handle a request
+   *
+   * @param request The request
+   * @param response The response
+   */
+  void handle(const ShmMessage& request, ShmMessage& response);
+
+  /**
+   * @brief Handle the requests of a channel until a shutdown request
+   *
+   * @param channel The channel
+   */
+  void serve(ShmChannel& channel);
+
+ private:
+  int problem_id = 0;                  ///< ID of the 0D problem
+  int system_size = 0;                 ///< Size of the 0D system
+  double* y = nullptr;                 ///< State of the 0D problem
+  double* y_trial = nullptr;           ///< Trial state of the 0D problem
+  std::vector<std::string> block_names;  ///< Names of the coupling blocks
+  std::vector<bool> block_is_flow;       ///< Whether each coupling block
+                                         ///< prescribes a flow
+  std::vector<int> response_ids;  ///< Indices of the response values in the
+                                  ///< state
+  std::vector<double> params;     ///< Work vector for the block parameters
+};
+
+#endif  // SVZERODSOLVER_INTERFACE_SHMTRANSPORT_HPP_
@@ -0,0 +1,89 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int num_threads) {
+  for (int i = 1; i < num_threads; i++) {
+    workers.emplace_back([this]() {
+      std::unique_lock<std::mutex> lock(mutex);
+      int last_generation = 0;
+      while (true) {
+        work_available.wait(
+            lock, [&]() { return stop || (generation != last_generation); });
+        if (stop) {
+          return;
+        }
+        last_generation = generation;
+        num_busy++;
+        work(lock);
+        num_busy--;
+        work_done.notify_all();
+      }
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  work_available.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+int ThreadPool::get_num_threads() const { return workers.size() + 1; }
+
+void ThreadPool::parallel_for(int num_tasks,
+                              const std::function<void(int)> &task) {
+  std::unique_lock<std::mutex> lock(mutex);
+  this->task = &task;
+  this->num_tasks = num_tasks;
+  next_task = 0;
+  generation++;
+  work_available.notify_all();
+
+  work(lock);
+
+  // Wait for the workers still working on the last tasks
+  work_done.wait(lock, [this]() { return num_busy == 0; });
+  this->task = nullptr;
+}
+
+void ThreadPool::work(std::unique_lock<std::mutex> &lock) {
+  while (next_task < num_tasks) {
+    int task_id = next_task++;
+    lock.unlock();
+    (*task)(task_id);
+    lock.lock();
+  }
+}
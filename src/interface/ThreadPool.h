@@ -0,0 +1,106 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file ThreadPool.h
+ * @brief ThreadPool source file
+ */
+#ifndef SVZERODSOLVER_INTERFACE_THREADPOOL_HPP_
+#define SVZERODSOLVER_INTERFACE_THREADPOOL_HPP_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of worker threads for parallel loops
+ *
+ * The threads are started once and wait for work between the loops, so that
+ * a loop over a few small tasks (e.g. one time step of each 0D model coupled
+ * to a 3D simulation) does not pay for starting threads. The calling thread
+ * takes part in the work.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Construct a new thread pool
+   *
+   * @param num_threads Number of threads including the calling thread
+   */
+  ThreadPool(int num_threads);
+
+  /**
+   * @brief Destroy the thread pool (waits for the worker threads to finish)
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Get the number of threads including the calling thread
+   *
+   * @return Number of threads
+   */
+  int get_num_threads() const;
+
+  /**
+   * @brief Call a task for all indices in [0, num_tasks) and wait for all
+   * calls to finish
+   *
+   * The tasks must not throw exceptions. Only one loop can run at a time.
+   *
+   * @param num_tasks Number of tasks
+   * @param task Task to call with the index of the task
+   */
+  void parallel_for(int num_tasks, const std::function<void(int)> &task);
+
+ private:
+  std::vector<std::thread> workers;  ///< Worker threads
+  std::mutex mutex;                  ///< Mutex for the loop data
+  std::condition_variable work_available;  ///< Signals a new loop
+  std::condition_variable work_done;  ///< Signals that a worker finished
+  const std::function<void(int)> *task{nullptr};  ///< Task of current loop
+  int num_tasks{0};     ///< Number of tasks of the current loop
+  int next_task{0};     ///< Index of the next task to start
+  int num_busy{0};      ///< Number of workers working on the current loop
+  int generation{0};    ///< Counter of the loops
+  bool stop{false};     ///< Whether the workers should finish
+
+  /**
+   * @brief Work on the tasks of the current loop until all are started
+   *
+   * @param lock Lock of the mutex (is released while working on a task)
+   */
+  void work(std::unique_lock<std::mutex> &lock);
+};
+
+#endif  // SVZERODSOLVER_INTERFACE_THREADPOOL_HPP_
@@ -30,25 +30,97 @@
 
 #include "interface.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
+#include <thread>
 
 #include "SimulationParameters.h"
+#include "ThreadPool.h"
 
 // Static member data.
-int SolverInterface::problem_id_count_ = 0;
-std::map<int, SolverInterface*> SolverInterface::interface_list_;
+InterfaceRegistry SolverInterface::registry_;
+
+//-------------------
+// InterfaceRegistry
+//-------------------
+InterfaceRegistry::~InterfaceRegistry() {
+  for (auto& chunk : chunks) {
+    delete[] chunk.load();
+  }
+}
+
+int InterfaceRegistry::add(SolverInterface* interface) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (num_ids == chunk_size * max_num_chunks) {
+    throw std::runtime_error("Maximum number of 0D problems reached.");
+  }
+  int problem_id = num_ids++;
+  auto& chunk = chunks[problem_id / chunk_size];
+  if (chunk.load(std::memory_order_relaxed) == nullptr) {
+    auto new_chunk = new Slot[chunk_size];
+    for (int i = 0; i < chunk_size; i++) {
+      new_chunk[i].store(nullptr, std::memory_order_relaxed);
+    }
+    chunk.store(new_chunk, std::memory_order_release);
+  }
+  chunk.load(std::memory_order_relaxed)[problem_id % chunk_size].store(
+      interface, std::memory_order_release);
+  return problem_id;
+}
+
+SolverInterface* InterfaceRegistry::get(int problem_id) const {
+  if ((problem_id < 0) || (problem_id >= chunk_size * max_num_chunks)) {
+    return nullptr;
+  }
+  auto chunk = chunks[problem_id / chunk_size].load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  return chunk[problem_id % chunk_size].load(std::memory_order_acquire);
+}
+
+SolverInterface* InterfaceRegistry::remove(int problem_id) {
+  if ((problem_id < 0) || (problem_id >= chunk_size * max_num_chunks)) {
+    return nullptr;
+  }
+  auto chunk = chunks[problem_id / chunk_size].load(std::memory_order_acquire);
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  return chunk[problem_id % chunk_size].exchange(nullptr,
+                                                 std::memory_order_acq_rel);
+}
 
 //-----------------
 // SolverInterface
 //-----------------
 SolverInterface::SolverInterface(const std::string& input_file_name)
     : input_file_name_(input_file_name) {
-  problem_id_ = problem_id_count_++;
-  SolverInterface::interface_list_[problem_id_] = this;
+  problem_id_ = registry_.add(this);
 }
 
 SolverInterface::~SolverInterface() {}
 
+void SolverInterface::update_integrator() {
+  if (integrator_outdated_) {
+    integrator_.update_params(time_step_size_);
+    integrator_outdated_ = false;
+    has_linearization_ = false;
+  }
+}
+
+/**
+ * @brief Find the interface of a 0D problem.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @return The interface (nullptr if there is no problem with this ID)
+ */
+static SolverInterface* find_interface(int problem_id) {
+  return SolverInterface::registry_.get(problem_id);
+}
+
 //////////////////////////////////////////////////////////
 //            Callable interface functions              //
 //////////////////////////////////////////////////////////
@@ -59,6 +131,8 @@ extern "C" void initialize(std::string input_file, int& problem_id,
                            std::vector<std::string>& block_names,
                            std::vector<std::string>& variable_names);
 
+extern "C" int finalize(int problem_id);
+
 extern "C" void set_external_step_size(int problem_id,
                                        double external_step_size);
 
@@ -86,6 +160,40 @@ extern "C" void return_y(int problem_id, std::vector<double>& ydot);
 
 extern "C" void return_ydot(int problem_id, std::vector<double>& ydot);
 
+// Functions without C++ types in their signature. They return 0 on success
+// and 1 on failure (unknown problem ID, wrong vector size or diverged time
+// step) instead of throwing exceptions.
+
+extern "C" int get_state_data(int problem_id, double** y, double** ydot,
+                              int* system_size);
+
+extern "C" int return_state_data(int problem_id, double* y, double* ydot,
+                                 int system_size);
+
+extern "C" int update_state_data(int problem_id, const double* y,
+                                 const double* ydot, int system_size);
+
+extern "C" int increment_time_data(int problem_id, const double external_time,
+                                   double* solution, int system_size);
+
+extern "C" int increment_time_batch(const int* problem_ids, int num_problems,
+                                    const double external_time,
+                                    int num_threads, int* error_codes);
+
+extern "C" int increment_time_trial(int problem_id, const double external_time);
+
+extern "C" int get_trial_state_data(int problem_id, double** y, double** ydot,
+                                    int* system_size);
+
+extern "C" int commit_time_step(int problem_id);
+
+extern "C" int checkpoint(int problem_id);
+
+extern "C" int rollback(int problem_id);
+
+extern "C" int get_block_tangent(int problem_id, const char* block_name,
+                                 double* tangent, int system_size);
+
 /**
  * @brief Initialize the 0D solver interface.
  *
@@ -159,6 +267,8 @@ void initialize(std::string input_file_arg, int& problem_id, int& pts_per_cycle,
   interface->rho_infty_ = simparams.sim_rho_infty;
   interface->max_nliter_ = simparams.sim_nliter;
   interface->absolute_tolerance_ = simparams.sim_abs_tol;
+  interface->jacobian_reuse_threshold_ = simparams.sim_jacobian_reuse_threshold;
+  interface->linear_solver_ = simparams.sim_linear_solver;
   interface->time_step_ = 0;
   interface->system_size_ = model->dofhandler.size();
   interface->num_time_steps_ = simparams.sim_num_time_steps;
@@ -196,27 +306,50 @@ void initialize(std::string input_file_arg, int& problem_id, int& pts_per_cycle,
     model_steady->to_steady();
     Integrator integrator_steady(
         model_steady.get(), time_step_size_steady, interface->rho_infty_,
-        interface->absolute_tolerance_, interface->max_nliter_);
+        interface->absolute_tolerance_, interface->max_nliter_,
+        interface->jacobian_reuse_threshold_, interface->linear_solver_);
 
-    for (size_t i = 0; i < 31; i++) {
-      state = integrator_steady.step(state, time_step_size_steady * double(i));
+    // Use pseudo-time steps if the Newton-Raphson iterations fail
+    if (!integrator_steady.solve_steady_state(state, 0.0)) {
+      DEBUG_MSG("[initialize] Use pseudo-time steps ... ");
+      for (size_t i = 0; i < 31; i++) {
+        integrator_steady.step_in_place(state,
+                                        time_step_size_steady * double(i));
+      }
     }
   }
   // TODO: Set back to unsteady
   interface->state_ = state;
-
-  // Initialize states and times vectors because size is now known
-  interface->times_.resize(num_output_steps);
-  interface->states_.resize(num_output_steps);
+  interface->trial_state_ = state;
 
   // Initialize integrator
   interface->integrator_ =
       Integrator(model.get(), interface->time_step_size_, interface->rho_infty_,
-                 interface->absolute_tolerance_, interface->max_nliter_);
+                 interface->absolute_tolerance_, interface->max_nliter_,
+                 interface->jacobian_reuse_threshold_,
+                 interface->linear_solver_);
 
   DEBUG_MSG("[initialize] Done");
 }
 
+/**
+ * @brief Delete the 0D problem and release its memory.
+ *
+ * The problem ID is invalid afterwards. This must not be called while other
+ * functions are called for the same problem.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @return 0 on success, 1 if the problem ID is unknown.
+ */
+int finalize(int problem_id) {
+  auto interface = SolverInterface::registry_.remove(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  delete interface;
+  return 0;
+}
+
 /**
  * @brief Set the timestep of the external program. For cases when 0D time step
  * depends on external time step.
@@ -225,7 +358,8 @@ void initialize(std::string input_file_arg, int& problem_id, int& pts_per_cycle,
  * @param external_step_size The time step size of the external program.
  */
 void set_external_step_size(int problem_id, double external_step_size) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
 
   // Update external step size in model and interface
@@ -234,7 +368,10 @@ void set_external_step_size(int problem_id, double external_step_size) {
   // Update time step size in interface
   double zerod_step_size =
       external_step_size / (double(interface->num_time_steps_) - 1.0);
-  interface->time_step_size_ = zerod_step_size;
+  if (zerod_step_size != interface->time_step_size_) {
+    interface->time_step_size_ = zerod_step_size;
+    interface->integrator_outdated_ = true;
+  }
 }
 
 /**
@@ -246,7 +383,8 @@ void set_external_step_size(int problem_id, double external_step_size) {
  */
 void update_block_params(int problem_id, std::string block_name,
                          std::vector<double>& params) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
 
   // Find the required block
@@ -261,15 +399,16 @@ void update_block_params(int problem_id, std::string block_name,
   // too?
   if ((block_type == BlockType::pressure_bc) ||
       (block_type == BlockType::flow_bc)) {
-    std::vector<double> times_new;
-    std::vector<double> values_new;
+    // Times and values are read in place from the parameter vector
     int num_time_pts = (int)params[0];
-    for (int i = 0; i < num_time_pts; i++) {
-      times_new.push_back(params[1 + i]);
-      values_new.push_back(params[1 + num_time_pts + i]);
+    const double* times_new = params.data() + 1;
+    const double* values_new = params.data() + 1 + num_time_pts;
+    auto param = model->get_parameter(block->global_param_ids[0]);
+    if (!param->has_time_series(times_new, values_new, num_time_pts)) {
+      param->update(times_new, values_new, num_time_pts);
+      model->set_parameter_changed(block->global_param_ids[0]);
+      interface->integrator_outdated_ = true;
     }
-    model->get_parameter(block->global_param_ids[0])
-        ->update(times_new, values_new);
   } else {
     if (block->global_param_ids.size() != params.size()) {
       throw std::runtime_error(
@@ -280,10 +419,16 @@ void update_block_params(int problem_id, std::string block_name,
           std::to_string(block->global_param_ids.size()) + ")");
     }
     for (size_t i = 0; i < params.size(); i++) {
-      model->get_parameter(block->global_param_ids[i])->update(params[i]);
+      auto param = model->get_parameter(block->global_param_ids[i]);
+      if (param->is_constant && (param->value == params[i])) {
+        continue;
+      }
+      param->update(params[i]);
       // parameter_values vector needs to be seperately updated for constant
       // parameters
       model->update_parameter_value(block->global_param_ids[i], params[i]);
+      model->set_parameter_changed(block->global_param_ids[i]);
+      interface->integrator_outdated_ = true;
     }
   }
 }
@@ -297,7 +442,7 @@ void update_block_params(int problem_id, std::string block_name,
  */
 void read_block_params(int problem_id, std::string block_name,
                        std::vector<double>& params) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
   auto model = interface->model_;
   auto block = model->get_block(block_name);
   if (block == nullptr) {
@@ -327,7 +472,7 @@ void read_block_params(int problem_id, std::string block_name,
  */
 void get_block_node_IDs(int problem_id, std::string block_name,
                         std::vector<int>& IDs) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
   auto model = interface->model_;
 
   // Find the required block
@@ -356,7 +501,8 @@ void get_block_node_IDs(int problem_id, std::string block_name,
  * @param y The state vector containing all state.y degrees-of-freedom.
  */
 void return_y(int problem_id, std::vector<double>& y) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
   auto system_size = interface->system_size_;
   if (y.size() != system_size) {
@@ -364,7 +510,7 @@ void return_y(int problem_id, std::vector<double>& y) {
         "ERROR: State vector size is wrong in return_y().");
   }
 
-  auto state = interface->state_;
+  auto& state = interface->state_;
   for (int i = 0; i < system_size; i++) {
     y[i] = state.y[i];
   }
@@ -377,7 +523,8 @@ void return_y(int problem_id, std::vector<double>& y) {
  * @param ydot The state vector containing all state.ydot degrees-of-freedom.
  */
 void return_ydot(int problem_id, std::vector<double>& ydot) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
   auto system_size = interface->system_size_;
   if (ydot.size() != system_size) {
@@ -385,7 +532,7 @@ void return_ydot(int problem_id, std::vector<double>& ydot) {
         "ERROR: State vector size is wrong in return_ydot().");
   }
 
-  auto state = interface->state_;
+  auto& state = interface->state_;
   for (int i = 0; i < system_size; i++) {
     ydot[i] = state.ydot[i];
   }
@@ -402,7 +549,8 @@ void return_ydot(int problem_id, std::vector<double>& ydot) {
  */
 void update_state(int problem_id, std::vector<double> new_state_y,
                   std::vector<double> new_state_ydot) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
   auto system_size = interface->system_size_;
   if ((new_state_y.size() != system_size) ||
@@ -411,12 +559,378 @@ void update_state(int problem_id, std::vector<double> new_state_y,
         "ERROR: State vector size is wrong in update_state().");
   }
 
-  auto state = interface->state_;
+  auto& state = interface->state_;
   for (int i = 0; i < system_size; i++) {
     state.y[i] = new_state_y[i];
     state.ydot[i] = new_state_ydot[i];
   }
-  interface->state_ = state;
+}
+
+/**
+ * @brief Get pointers to the state vectors of the 0D problem.
+ *
+ * The pointers stay valid for the lifetime of the interface. The external
+ * program can read and modify the state through them without any copies
+ * (instead of using return_y(), return_ydot(), and update_state()).
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param y Pointer to the state.y degrees-of-freedom.
+ * @param ydot Pointer to the state.ydot degrees-of-freedom.
+ * @param system_size Length of the state vectors.
+ * @return 0 on success, 1 if the problem ID is unknown.
+ */
+int get_state_data(int problem_id, double** y, double** ydot,
+                   int* system_size) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  *y = interface->state_.y.data();
+  *ydot = interface->state_.ydot.data();
+  *system_size = interface->system_size_;
+  return 0;
+}
+
+/**
+ * @brief Copy the state vectors of the 0D problem to arrays.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param y Array for the state.y degrees-of-freedom.
+ * @param ydot Array for the state.ydot degrees-of-freedom.
+ * @param system_size Length of the arrays.
+ * @return 0 on success, 1 if the problem ID or the length is wrong.
+ */
+int return_state_data(int problem_id, double* y, double* ydot,
+                      int system_size) {
+  auto interface = find_interface(problem_id);
+  if ((interface == nullptr) || (system_size != interface->system_size_)) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+  std::copy_n(interface->state_.y.data(), system_size, y);
+  std::copy_n(interface->state_.ydot.data(), system_size, ydot);
+  return 0;
+}
+
+/**
+ * @brief Update the state vectors of the 0D problem from arrays.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param y Array with the new state.y degrees-of-freedom.
+ * @param ydot Array with the new state.ydot degrees-of-freedom.
+ * @param system_size Length of the arrays.
+ * @return 0 on success, 1 if the problem ID or the length is wrong.
+ */
+int update_state_data(int problem_id, const double* y, const double* ydot,
+                      int system_size) {
+  auto interface = find_interface(problem_id);
+  if ((interface == nullptr) || (system_size != interface->system_size_)) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+  std::copy_n(y, system_size, interface->state_.y.data());
+  std::copy_n(ydot, system_size, interface->state_.ydot.data());
+  return 0;
+}
+
+/**
+ * @brief Increment the 0D solution by one time step.
+ *
+ * Same as increment_time() but with an array for the solution. The state
+ * vectors are updated in place (see get_state_data()).
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param external_time The current time in the external program.
+ * @param solution Array for the solution at the beginning of the time step
+ * (can be nullptr).
+ * @param system_size Length of the solution array.
+ * @return 0 on success, 1 if the problem ID or the length is wrong or the
+ * non-linear iterations did not converge (the state is then unchanged).
+ */
+int increment_time_data(int problem_id, const double external_time,
+                        double* solution, int system_size) {
+  auto interface = find_interface(problem_id);
+  if ((interface == nullptr) ||
+      ((solution != nullptr) && (system_size != interface->system_size_))) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+
+  interface->update_integrator();
+
+  auto& state = interface->state_;
+  if (solution != nullptr) {
+    std::copy_n(state.y.data(), system_size, solution);
+  }
+
+  interface->has_linearization_ = false;
+  try {
+    interface->integrator_.step_in_place(state, external_time);
+  } catch (const std::runtime_error&) {
+    return 1;
+  }
+  interface->has_linearization_ = true;
+  interface->time_step_ += 1;
+  return 0;
+}
+
+/**
+ * @brief Thread pool for increment_time_batch() (recreated when the number
+ * of threads changes)
+ */
+static std::unique_ptr<ThreadPool> thread_pool;
+static std::mutex thread_pool_mutex;
+
+/**
+ * @brief Increment the 0D solutions of multiple problems by one time step.
+ *
+ * The problems are independent and distributed over a pool of threads. Each
+ * problem ID should appear only once in the list. The new states can be
+ * accessed without copies through get_state_data().
+ *
+ * @param problem_ids Array with the IDs of the 0D problems.
+ * @param num_problems Number of 0D problems.
+ * @param external_time The current time in the external program.
+ * @param num_threads Number of threads (0 uses all available cores).
+ * @param error_codes Array for the return value of increment_time_data() for
+ * each problem (can be nullptr).
+ * @return 0 on success, 1 if the time step failed for any problem.
+ */
+int increment_time_batch(const int* problem_ids, int num_problems,
+                         const double external_time, int num_threads,
+                         int* error_codes) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1, int(std::thread::hardware_concurrency()));
+  }
+
+  std::atomic<int> num_errors{0};
+  auto task = [&](int i) {
+    int error_code =
+        increment_time_data(problem_ids[i], external_time, nullptr, 0);
+    if (error_codes != nullptr) {
+      error_codes[i] = error_code;
+    }
+    num_errors += error_code;
+  };
+
+  std::lock_guard<std::mutex> lock(thread_pool_mutex);
+  if ((num_threads == 1) || (num_problems == 1)) {
+    for (int i = 0; i < num_problems; i++) {
+      task(i);
+    }
+  } else {
+    if (!thread_pool || (thread_pool->get_num_threads() != num_threads)) {
+      thread_pool = std::make_unique<ThreadPool>(num_threads);
+    }
+    thread_pool->parallel_for(num_problems, task);
+  }
+
+  return (num_errors > 0) ? 1 : 0;
+}
+
+/**
+ * @brief Compute a trial time step without changing the state.
+ *
+ * For strongly coupled simulations, where the external program repeats a
+ * time step with updated boundary values until convergence. The trial step
+ * always starts from the current state. It can be accessed through
+ * get_trial_state_data() and is only applied to the state by
+ * commit_time_step(). Discarding a trial step does not require any copies.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param external_time The current time in the external program.
+ * @return 0 on success, 1 if the problem ID is unknown or the non-linear
+ * iterations did not converge.
+ */
+int increment_time_trial(int problem_id, const double external_time) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+
+  interface->update_integrator();
+  interface->trial_pending_ = false;
+  interface->has_linearization_ = false;
+  try {
+    interface->integrator_.step(interface->state_, interface->trial_state_,
+                                external_time);
+  } catch (const std::runtime_error&) {
+    return 1;
+  }
+  interface->trial_pending_ = true;
+  interface->has_linearization_ = true;
+  return 0;
+}
+
+/**
+ * @brief Get pointers to the state vectors of the last trial time step.
+ *
+ * The pointers stay valid for the lifetime of the interface.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param y Pointer to the state.y degrees-of-freedom.
+ * @param ydot Pointer to the state.ydot degrees-of-freedom.
+ * @param system_size Length of the state vectors.
+ * @return 0 on success, 1 if the problem ID is unknown.
+ */
+int get_trial_state_data(int problem_id, double** y, double** ydot,
+                         int* system_size) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  *y = interface->trial_state_.y.data();
+  *ydot = interface->trial_state_.ydot.data();
+  *system_size = interface->system_size_;
+  return 0;
+}
+
+/**
+ * @brief Apply the last trial time step to the state.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @return 0 on success, 1 if the problem ID is unknown or there is no trial
+ * time step to commit.
+ */
+int commit_time_step(int problem_id) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+  if (!interface->trial_pending_) {
+    return 1;
+  }
+  interface->state_.y = interface->trial_state_.y;
+  interface->state_.ydot = interface->trial_state_.ydot;
+  interface->trial_pending_ = false;
+  interface->time_step_ += 1;
+  return 0;
+}
+
+/**
+ * @brief Save the state and the parameters of the 0D problem.
+ *
+ * The checkpoint can be restored with rollback(). Only the first checkpoint
+ * allocates memory.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @return 0 on success, 1 if the problem ID is unknown.
+ */
+int checkpoint(int problem_id) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+
+  auto model = interface->model_;
+  int num_parameters = model->get_num_parameters();
+  auto& parameters = interface->checkpoint_parameters_;
+  interface->checkpoint_parameter_values_.resize(num_parameters);
+  for (int i = 0; i < num_parameters; i++) {
+    if (i < parameters.size()) {
+      parameters[i] = *model->get_parameter(i);
+    } else {
+      parameters.push_back(*model->get_parameter(i));
+    }
+    interface->checkpoint_parameter_values_[i] = model->get_parameter_value(i);
+  }
+  interface->checkpoint_state_ = interface->state_;
+  interface->checkpoint_time_step_ = interface->time_step_;
+  interface->has_checkpoint_ = true;
+  return 0;
+}
+
+/**
+ * @brief Restore the state and the parameters of the last checkpoint.
+ *
+ * Pending trial time steps are discarded. The checkpoint is kept, i.e.
+ * multiple rollbacks to the same checkpoint are possible.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @return 0 on success, 1 if the problem ID is unknown or no checkpoint was
+ * set.
+ */
+int rollback(int problem_id) {
+  auto interface = find_interface(problem_id);
+  if (interface == nullptr) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+  if (!interface->has_checkpoint_) {
+    return 1;
+  }
+
+  auto model = interface->model_;
+  for (int i = 0; i < model->get_num_parameters(); i++) {
+    *model->get_parameter(i) = interface->checkpoint_parameters_[i];
+    model->update_parameter_value(i,
+                                  interface->checkpoint_parameter_values_[i]);
+    model->set_parameter_changed(i);
+  }
+  interface->integrator_outdated_ = true;
+  interface->state_.y = interface->checkpoint_state_.y;
+  interface->state_.ydot = interface->checkpoint_state_.ydot;
+  interface->time_step_ = interface->checkpoint_time_step_;
+  interface->trial_pending_ = false;
+  interface->has_linearization_ = false;
+  return 0;
+}
+
+/**
+ * @brief Compute the sensitivity of the last time step to the boundary value
+ * of a block.
+ *
+ * Returns the derivatives of the new state of the last time step (see
+ * increment_time_data() and increment_time_trial()) with respect to the flow
+ * or pressure prescribed by a FLOW or PRESSURE block, e.g. the derivative of
+ * the pressure at a coupled outlet with respect to its flow for implicit
+ * coupling with a 3D solver. The derivatives of the node quantities of a block
+ * are found at the IDs returned by get_block_node_IDs(). This costs one
+ * back-substitution with the factorized jacobian of the last time step.
+ *
+ * @param problem_id The ID used to identify the 0D problem.
+ * @param block_name The name of the FLOW or PRESSURE block.
+ * @param tangent Array for the derivatives of all degrees-of-freedom.
+ * @param system_size Length of the tangent array.
+ * @return 0 on success, 1 if the problem ID, the block or the length is
+ * wrong, no time step was computed since the last change of the time step
+ * size or the parameters, or the jacobian is singular.
+ */
+int get_block_tangent(int problem_id, const char* block_name, double* tangent,
+                      int system_size) {
+  auto interface = find_interface(problem_id);
+  if ((interface == nullptr) || (system_size != interface->system_size_)) {
+    return 1;
+  }
+  std::lock_guard<std::mutex> lock(interface->mutex_);
+  if (!interface->has_linearization_) {
+    return 1;
+  }
+
+  auto model = interface->model_;
+  auto block = model->get_block(block_name);
+  if (block == nullptr) {
+    return 1;
+  }
+  auto block_type = model->get_block_type(block_name);
+  if ((block_type != BlockType::pressure_bc) &&
+      (block_type != BlockType::flow_bc)) {
+    return 1;
+  }
+
+  // The boundary value enters the equation of the block as c_i = -value
+  auto& dy_dc = interface->tangent_;
+  if (!interface->integrator_.solve_sensitivity(block->global_eqn_ids[0],
+                                                dy_dc)) {
+    return 1;
+  }
+  for (int i = 0; i < system_size; i++) {
+    tangent[i] = -dy_dc[i];
+  }
+  return 0;
 }
 
 /**
@@ -428,21 +942,22 @@ void update_state(int problem_id, std::vector<double> new_state_y,
  */
 void increment_time(int problem_id, const double external_time,
                     std::vector<double>& solution) {
-  auto interface = SolverInterface::interface_list_[problem_id];
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
   auto model = interface->model_;
 
-  auto time_step_size = interface->time_step_size_;
-  auto absolute_tolerance = interface->absolute_tolerance_;
-  auto max_nliter = interface->max_nliter_;
-  Integrator integrator(model.get(), time_step_size, interface->rho_infty_,
-                        absolute_tolerance, max_nliter);
-  auto state = interface->state_;
-  interface->state_ = integrator.step(state, external_time);
-  interface->time_step_ += 1;
+  interface->update_integrator();
 
+  // The solution is the state at the beginning of the time step
+  auto& state = interface->state_;
   for (int i = 0; i < state.y.size(); i++) {
     solution[i] = state.y[i];
   }
+
+  interface->has_linearization_ = false;
+  interface->integrator_.step_in_place(state, external_time);
+  interface->has_linearization_ = true;
+  interface->time_step_ += 1;
 }
 
 /**
@@ -454,82 +969,69 @@ void increment_time(int problem_id, const double external_time,
  * vectors.
  * @param output_solutions The solution vector containing all degrees-of-freedom
  * stored sequentially (1D vector).
- * @param error_code This is 1 if a NaN is found in the solution vector, 0
- * otherwise.
+ * @param error_code This is 1 if a NaN or Inf is found in the solution vector,
+ * 0 otherwise.
  */
 void run_simulation(int problem_id, const double external_time,
                     std::vector<double>& output_times,
                     std::vector<double>& output_solutions, int& error_code) {
-  auto interface = SolverInterface::interface_list_[problem_id];
-  auto model = interface->model_;
+  auto interface = find_interface(problem_id);
+  std::lock_guard<std::mutex> lock(interface->mutex_);
 
   auto time_step_size = interface->time_step_size_;
-  auto absolute_tolerance = interface->absolute_tolerance_;
-  auto max_nliter = interface->max_nliter_;
   auto num_time_steps = interface->num_time_steps_;
   auto system_size = interface->system_size_;
   auto num_output_steps = interface->num_output_steps_;
 
-  auto integrator = interface->integrator_;
-  integrator.update_params(time_step_size);
+  if (interface->output_last_cycle_only_) {  // NOT TESTED
+    throw std::runtime_error(
+        "ERROR: Option output_last_cycle_only has been implemented but not "
+        "tested when using the svZeroDPlus interface library. Please test this "
+        "functionality before removing this message.");
+  }
+  if (output_solutions.size() != num_output_steps * system_size) {
+    throw std::runtime_error("Solution vector size is wrong.");
+  }
+  if (output_times.size() < num_output_steps) {
+    throw std::runtime_error("Time vector size is wrong.");
+  }
 
+  interface->update_integrator();
+  auto& integrator = interface->integrator_;
+  interface->has_linearization_ = false;
+
+  // States are written to the (time-major) output vector during the
+  // integration
   auto state = interface->state_;
   double time = external_time;
-
-  interface->times_[0] = time;
-  interface->states_[0] = state;
+  auto write_output = [&](int t) {
+    if (t < num_output_steps) {
+      output_times[t] = time;
+      std::copy_n(state.y.data(), system_size,
+                  output_solutions.data() + t * system_size);
+    }
+  };
+  write_output(0);
 
   // Run integrator
   interface->time_step_ = 0;
   error_code = 0;
-  bool isNaN = false;
   for (int i = 1; i < num_time_steps; i++) {
     interface->time_step_ += 1;
-    state = integrator.step(state, time);
-    // Check for NaNs in the state vector
-    if ((i % 100) == 0) {
-      for (int j = 0; j < system_size; j++) {
-        isNaN = (state.y[j] != state.y[j]);
-        if (isNaN) {
-          std::cout << "Found NaN in state vector at timestep " << i
-                    << " and index " << j << std::endl;
-          error_code = 1;
-          return;
-        }
+    integrator.step_in_place(state, time);
+    // Check for NaNs and Infs in the state vector
+    if (!state.y.allFinite()) {
+      int j = 0;
+      while (std::isfinite(state.y[j])) {
+        j++;
       }
+      std::cout << "Found NaN or Inf in state vector at timestep " << i
+                << " and index " << j << std::endl;
+      error_code = 1;
+      return;
     }
     time += time_step_size;
-    interface->times_[i] = time;
-    interface->states_[i] = state;
+    write_output(i);
   }
   interface->state_ = state;
-
-  // Write states to solution output vector
-  if (output_solutions.size() != num_output_steps * system_size) {
-    throw std::runtime_error("Solution vector size is wrong.");
-  }
-  int output_idx = 0;
-  int soln_idx = 0;
-  int start_idx = 0;
-  double start_time = 0.0;
-  if (interface->output_last_cycle_only_) {  // NOT TESTED
-    start_idx = interface->num_time_steps_ - interface->pts_per_cycle_;
-    start_time = interface->times_[start_idx];
-    throw std::runtime_error(
-        "ERROR: Option output_last_cycle_only has been implemented but not "
-        "tested when using the svZeroDPlus interface library. Please test this "
-        "functionality before removing this message.");
-  }
-  for (int t = start_idx; t < num_output_steps; t++) {
-    state = interface->states_[t];
-    output_times[t] = interface->times_[t] - start_time;
-    for (int i = 0; i < system_size; i++) {
-      soln_idx = output_idx * system_size + i;
-      output_solutions[soln_idx] = state.y[i];
-    }
-    output_idx++;
-  }
-
-  // Release dynamic memory
-  // integrator.clean();
 }
@@ -32,7 +32,9 @@
  * @brief svZeroDSolver callable interface.
  */
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -44,6 +46,63 @@
 #include "csv_writer.h"
 #include "debug.h"
 
+class SolverInterface;
+
+/**
+ * @brief Registry of the interfaces of all 0D problems
+ *
+ * The problem ID of an interface is its index in a slab of slots. The slab is
+ * allocated in chunks that are only freed with the registry. Looking up an
+ * interface is therefore a lock-free read that is safe while other threads
+ * add or remove interfaces. Problem IDs are not reused, so that the ID of a
+ * removed interface never refers to another one.
+ */
+class InterfaceRegistry {
+ public:
+  InterfaceRegistry() = default;
+
+  /**
+   * @brief Destroy the registry (does not delete the interfaces)
+   */
+  ~InterfaceRegistry();
+
+  InterfaceRegistry(const InterfaceRegistry&) = delete;
+  InterfaceRegistry& operator=(const InterfaceRegistry&) = delete;
+
+  /**
+   * @brief Add an interface
+   *
+   * @param interface The interface
+   * @return The problem ID of the interface
+   */
+  int add(SolverInterface* interface);
+
+  /**
+   * @brief Get an interface
+   *
+   * @param problem_id The problem ID of the interface
+   * @return The interface (nullptr if there is no interface with this ID)
+   */
+  SolverInterface* get(int problem_id) const;
+
+  /**
+   * @brief Remove an interface
+   *
+   * @param problem_id The problem ID of the interface
+   * @return The removed interface (nullptr if there is no interface with this
+   * ID)
+   */
+  SolverInterface* remove(int problem_id);
+
+ private:
+  using Slot = std::atomic<SolverInterface*>;
+  static constexpr int chunk_size = 1024;      ///< Number of slots per chunk
+  static constexpr int max_num_chunks = 1024;  ///< Maximum number of chunks
+  std::atomic<Slot*> chunks[max_num_chunks] = {};  ///< Chunks of slots
+  int num_ids = 0;   ///< Number of assigned problem IDs
+  std::mutex mutex;  ///< Mutex for adding interfaces
+};
+
 /**
  * @brief Interface class for calling svZeroD from external programs
  */
@@ -61,13 +120,15 @@ class SolverInterface {
   ~SolverInterface();
 
   /**
-   * @brief Counter for the number of interfaces
+   * @brief Update the integrator if the time step size or the block
+   * parameters changed since the last update
    */
-  static int problem_id_count_;
+  void update_integrator();
+
   /**
-   * @brief List of interfaces
+   * @brief Registry of all interfaces
    */
-  static std::map<int, SolverInterface*> interface_list_;
+  static InterfaceRegistry registry_;
 
   /**
    * @brief ID of current interface
@@ -109,6 +170,14 @@ class SolverInterface {
    * @brief Maximum number of non-linear iterations
    */
   int max_nliter_ = 0;
+  /**
+   * @brief Maximum residual contraction for reusing outdated jacobians
+   */
+  double jacobian_reuse_threshold_ = 0.0;
+  /**
+   * @brief Type of the linear solver
+   */
+  LinearSolverType linear_solver_ = LinearSolverType::automatic;
   /**
    * @brief Current time step
    */
@@ -135,20 +204,61 @@ class SolverInterface {
    */
   std::shared_ptr<Model> model_;
   /**
-   * @brief The current 0D integrator object
+   * @brief The 0D integrator object (kept for the lifetime of the interface)
    */
   Integrator integrator_;
+  /**
+   * @brief Whether the time step size or block parameters changed since the
+   * last update of the integrator
+   */
+  bool integrator_outdated_ = false;
+  /**
+   * @brief Whether the integrator holds the linearization of the last time
+   * step (see get_block_tangent())
+   */
+  bool has_linearization_ = false;
+  /**
+   * @brief Work vector for the sensitivities of the last time step
+   */
+  Eigen::Matrix<double, Eigen::Dynamic, 1> tangent_;
+  /**
+   * @brief Mutex for the model, integrator and state of the interface
+   *
+   * Different interfaces can be used concurrently (see
+   * increment_time_batch()).
+   */
+  std::mutex mutex_;
 
   /**
    * @brief The current 0D state vector
    */
   State state_;
   /**
-   * @brief Vector to store solution times
+   * @brief State of the last trial time step (see increment_time_trial())
+   */
+  State trial_state_;
+  /**
+   * @brief Whether the trial state holds a time step that can be committed
+   */
+  bool trial_pending_ = false;
+  /**
+   * @brief State at the last checkpoint (see checkpoint())
+   */
+  State checkpoint_state_;
+  /**
+   * @brief Current time step at the last checkpoint
+   */
+  int checkpoint_time_step_ = 0;
+  /**
+   * @brief Parameters of the model at the last checkpoint
+   */
+  std::vector<Parameter> checkpoint_parameters_;
+  /**
+   * @brief Current parameter values of the model at the last checkpoint
    */
-  std::vector<double> times_;
+  std::vector<double> checkpoint_parameter_values_;
   /**
-   * @brief Vector to store solution states
+   * @brief Whether a checkpoint was set
    */
-  std::vector<State> states_;
+  bool has_checkpoint_ = false;
 };
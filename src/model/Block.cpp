@@ -72,6 +72,12 @@ void Block::setup_dofs(DOFHandler &dofhandler) {}
 
 void Block::setup_model_dependent_params() {}
 
+void Block::register_slot(SystemMatrix matrix, int row, int col) {
+  global_slot_ids.push_back(model->register_slot(matrix, row, col));
+}
+
+void Block::setup_slots() {}
+
 void Block::update_constant(SparseSystem &system,
                             std::vector<double> &parameters) {}
 
@@ -85,6 +91,10 @@ void Block::update_solution(
 
 void Block::post_solve(Eigen::Matrix<double, Eigen::Dynamic, 1> &y) {}
 
+int Block::get_dependencies() {
+  return TIME_DEPENDENT | SOLUTION_DEPENDENT | POST_SOLVE;
+}
+
 void Block::update_gradient(Eigen::SparseMatrix<double> &jacobian,
                             Eigen::Matrix<double, Eigen::Dynamic, 1> &residual,
                             Eigen::Matrix<double, Eigen::Dynamic, 1> &alpha,
@@ -97,6 +97,19 @@ class Model;
  */
 class Block {
  public:
+  /**
+   * @brief Dependencies of the contributions of a block
+   *
+   * Determines in which phases of the assembly the model visits the block.
+   *
+   */
+  enum Dependency {
+    CONSTANT = 0,            ///< Only constant contributions
+    TIME_DEPENDENT = 1,      ///< Contributions in update_time
+    SOLUTION_DEPENDENT = 2,  ///< Contributions in update_solution
+    POST_SOLVE = 4,          ///< Modifies the solution in post_solve
+  };
+
   /**
    * @brief Construct a new Block object
    *
@@ -158,6 +171,16 @@ class Block {
    */
   std::vector<int> global_eqn_ids;
 
+  /**
+   * @brief Global IDs of the registered system matrix entries of the block
+   *
+   * Entries of the system matrices that are updated in every time step or
+   * nonlinear iteration are registered once in setup_slots(). The
+   * contributions are then written directly into the value arrays of the
+   * system matrices with SparseSystem::slot.
+   */
+  std::vector<int> global_slot_ids;
+
   /**
    * @brief Get the name of the block
    *
@@ -199,6 +222,25 @@ class Block {
    */
   virtual void setup_model_dependent_params();
 
+  /**
+   * @brief Register an entry of a system matrix that the block updates
+   * repeatedly
+   *
+   * Appends the global ID of the slot to \ref global_slot_ids.
+   *
+   * @param matrix System matrix of the entry
+   * @param row Row of the entry
+   * @param col Column of the entry
+   */
+  void register_slot(SystemMatrix matrix, int row, int col);
+
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  virtual void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse system
    *
@@ -254,6 +296,15 @@ class Block {
       Eigen::Matrix<double, Eigen::Dynamic, 1> &alpha, std::vector<double> &y,
       std::vector<double> &dy);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * Blocks that do not override this are visited in all phases.
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  virtual int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
@@ -34,6 +34,12 @@ void BloodVessel::setup_dofs(DOFHandler &dofhandler) {
   Block::setup_dofs_(dofhandler, 2, {});
 }
 
+void BloodVessel::setup_slots() {
+  register_slot(SystemMatrix::dC_dy, global_eqn_ids[0], global_var_ids[1]);
+  register_slot(SystemMatrix::dC_dy, global_eqn_ids[1], global_var_ids[1]);
+  register_slot(SystemMatrix::dC_dydot, global_eqn_ids[1], global_var_ids[1]);
+}
+
 void BloodVessel::update_constant(SparseSystem &system,
                                   std::vector<double> &parameters) {
   // Get parameters
@@ -70,13 +76,11 @@ void BloodVessel::update_solution(
   system.C(global_eqn_ids[1]) = stenosis_resistance * 2.0 * capacitance * dq_in;
 
   double sgn_q_in = (0.0 < q_in) - (q_in < 0.0);
-  system.dC_dy.coeffRef(global_eqn_ids[0], global_var_ids[1]) =
-      stenosis_coeff * sgn_q_in * -2.0 * q_in;
-  system.dC_dy.coeffRef(global_eqn_ids[1], global_var_ids[1]) =
+  system.slot(global_slot_ids[0]) = stenosis_coeff * sgn_q_in * -2.0 * q_in;
+  system.slot(global_slot_ids[1]) =
       stenosis_coeff * sgn_q_in * 2.0 * capacitance * dq_in;
 
-  system.dC_dydot.coeffRef(global_eqn_ids[1], global_var_ids[1]) =
-      stenosis_resistance * 2.0 * capacitance;
+  system.slot(global_slot_ids[2]) = stenosis_resistance * 2.0 * capacitance;
 }
 
 void BloodVessel::update_gradient(
@@ -125,3 +129,5 @@ void BloodVessel::update_gradient(
       y1 - y3 - capacitance * dy0 +
       capacitance * (resistance + 2.0 * stenosis_resistance) * dy1;
 }
+
+int BloodVessel::get_dependencies() { return SOLUTION_DEPENDENT; }
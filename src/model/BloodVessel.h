@@ -140,7 +140,7 @@
  * * `3` Stenosis coefficient
  *
  */
-class BloodVessel : public Block {
+class BloodVessel final : public Block {
  public:
   /**
    * @brief Local IDs of the parameters
@@ -175,6 +175,13 @@ class BloodVessel : public Block {
    */
   void setup_dofs(DOFHandler &dofhandler);
 
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse
    system
@@ -212,6 +219,13 @@ class BloodVessel : public Block {
                        Eigen::Matrix<double, Eigen::Dynamic, 1> &alpha,
                        std::vector<double> &y, std::vector<double> &dy);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
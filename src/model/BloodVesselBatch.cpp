@@ -0,0 +1,153 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#include "BloodVesselBatch.h"
+
+void BloodVesselBatch::setup(const std::vector<Block *> &blocks) {
+  vessels.clear();
+  for (Block *block : blocks) {
+    vessels.push_back(static_cast<BloodVessel *>(block));
+  }
+  has_stenosis.assign(vessels.size(), false);
+  stenosis_ids.clear();
+  capacitance_ids.clear();
+  var_ids.clear();
+  for (auto &ids : eqn_ids) {
+    ids.clear();
+  }
+  for (auto &ids : slot_ids) {
+    ids.clear();
+  }
+}
+
+void BloodVesselBatch::update_time(SparseSystem &system,
+                                   std::vector<double> &parameters) {
+  // Check if the set of vessels with stenosis changed
+  bool changed = false;
+  for (size_t i = 0; i < vessels.size(); i++) {
+    int param_id =
+        vessels[i]->global_param_ids[BloodVessel::STENOSIS_COEFFICIENT];
+    bool stenosis = parameters[param_id] != 0.0;
+    if (stenosis != has_stenosis[i]) {
+      has_stenosis[i] = stenosis;
+      changed = true;
+    }
+  }
+  if (!changed) {
+    return;
+  }
+
+  // Collect the indices of the vessels with stenosis
+  stenosis_ids.clear();
+  capacitance_ids.clear();
+  var_ids.clear();
+  for (auto &ids : eqn_ids) {
+    ids.clear();
+  }
+  for (auto &ids : slot_ids) {
+    ids.clear();
+  }
+  for (size_t i = 0; i < vessels.size(); i++) {
+    if (!has_stenosis[i]) {
+      continue;
+    }
+    auto vessel = vessels[i];
+    stenosis_ids.push_back(
+        vessel->global_param_ids[BloodVessel::STENOSIS_COEFFICIENT]);
+    capacitance_ids.push_back(
+        vessel->global_param_ids[BloodVessel::CAPACITANCE]);
+    var_ids.push_back(vessel->global_var_ids[1]);
+    for (int j = 0; j < 2; j++) {
+      eqn_ids[j].push_back(vessel->global_eqn_ids[j]);
+    }
+    for (int j = 0; j < 3; j++) {
+      slot_ids[j].push_back(vessel->global_slot_ids[j]);
+    }
+  }
+
+  int n = var_ids.size();
+  for (auto array : {&stenosis_coeff, &capacitance, &q_in, &dq_in,
+                     &stenosis_resistance, &sgn_q_in, &c[0], &c[1],
+                     &slot_values[0], &slot_values[1], &slot_values[2]}) {
+    array->resize(n);
+  }
+
+  reset_contributions(system);
+}
+
+void BloodVesselBatch::update_solution(
+    SparseSystem &system, std::vector<double> &parameters,
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> &y,
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> &dy) {
+  int n = var_ids.size();
+  if (n == 0) {
+    return;
+  }
+
+  // Gather parameters and inflows
+  for (int i = 0; i < n; i++) {
+    stenosis_coeff[i] = parameters[stenosis_ids[i]];
+    capacitance[i] = parameters[capacitance_ids[i]];
+    q_in[i] = y[var_ids[i]];
+    dq_in[i] = dy[var_ids[i]];
+  }
+
+  // Evaluate the contributions (same operations as in
+  // BloodVessel::update_solution)
+  stenosis_resistance = stenosis_coeff * q_in.abs();
+  sgn_q_in = (q_in > 0.0).cast<double>() - (q_in < 0.0).cast<double>();
+  c[0] = stenosis_resistance * -q_in;
+  c[1] = stenosis_resistance * 2.0 * capacitance * dq_in;
+  slot_values[0] = stenosis_coeff * sgn_q_in * -2.0 * q_in;
+  slot_values[1] = stenosis_coeff * sgn_q_in * 2.0 * capacitance * dq_in;
+  slot_values[2] = stenosis_resistance * 2.0 * capacitance;
+
+  // Scatter the contributions into the system
+  for (int i = 0; i < n; i++) {
+    system.C(eqn_ids[0][i]) = c[0][i];
+    system.C(eqn_ids[1][i]) = c[1][i];
+    system.slot(slot_ids[0][i]) = slot_values[0][i];
+    system.slot(slot_ids[1][i]) = slot_values[1][i];
+    system.slot(slot_ids[2][i]) = slot_values[2][i];
+  }
+}
+
+void BloodVesselBatch::reset_contributions(SparseSystem &system) {
+  for (size_t i = 0; i < vessels.size(); i++) {
+    if (has_stenosis[i]) {
+      continue;
+    }
+    auto vessel = vessels[i];
+    system.C(vessel->global_eqn_ids[0]) = 0.0;
+    system.C(vessel->global_eqn_ids[1]) = 0.0;
+    for (int j = 0; j < 3; j++) {
+      system.slot(vessel->global_slot_ids[j]) = 0.0;
+    }
+  }
+}
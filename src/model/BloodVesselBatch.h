@@ -0,0 +1,117 @@
+// Copyright (c) Stanford University, The Regents of the University of
+//               California, and others.
+//
+// All Rights Reserved.
+//
+// See Copyright-SimVascular.txt for additional details.
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to
+// permit persons to whom the Software is furnished to do so, subject
+// to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+// IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+// TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+// OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+/**
+ * @file BloodVesselBatch.h
+ * @brief model::BloodVesselBatch source file
+ */
+#ifndef SVZERODSOLVER_MODEL_BLOODVESSELBATCH_HPP_
+#define SVZERODSOLVER_MODEL_BLOODVESSELBATCH_HPP_
+
+#include <Eigen/Dense>
+#include <vector>
+
+#include "Block.h"
+#include "BloodVessel.h"
+#include "SparseSystem.h"
+
+/**
+ * @brief Solution-dependent contributions of all blood vessels of a model
+ *
+ * Evaluates the stenosis terms of BloodVessel::update_solution for all
+ * vessels at once instead of one vessel at a time. The inflows of the
+ * vessels are gathered into contiguous arrays, the contributions are
+ * evaluated with Eigen array expressions (which are vectorized) and the
+ * results are scattered into the system.
+ *
+ * Vessels without stenosis (stenosis coefficient of zero) have no
+ * solution-dependent contributions and are skipped.
+ */
+class BloodVesselBatch {
+ public:
+  /**
+   * @brief Set up the batch for the blood vessels of a model
+   *
+   * @param blocks Blood vessel blocks of the model
+   */
+  void setup(const std::vector<Block *> &blocks);
+
+  /**
+   * @brief Update the set of vessels with stenosis
+   *
+   * Needs to be called after the parameters changed. The contributions of
+   * vessels whose stenosis coefficient became zero are reset.
+   *
+   * @param system System to update contributions at
+   * @param parameters Parameters of the model
+   */
+  void update_time(SparseSystem &system, std::vector<double> &parameters);
+
+  /**
+   * @brief Update the solution-dependent contributions of all vessels
+   *
+   * @param system System to update contributions at
+   * @param parameters Parameters of the model
+   * @param y Current solution
+   * @param dy Current derivate of the solution
+   */
+  void update_solution(SparseSystem &system, std::vector<double> &parameters,
+                       const Eigen::Matrix<double, Eigen::Dynamic, 1> &y,
+                       const Eigen::Matrix<double, Eigen::Dynamic, 1> &dy);
+
+ private:
+  std::vector<BloodVessel *> vessels;  ///< All blood vessels
+  std::vector<bool> has_stenosis;      ///< Whether each vessel has stenosis
+
+  // Indices of the vessels with stenosis (struct of arrays)
+  std::vector<int> stenosis_ids;     ///< Stenosis coefficient parameters
+  std::vector<int> capacitance_ids;  ///< Capacitance parameters
+  std::vector<int> var_ids;          ///< Inflow variables
+  std::vector<int> eqn_ids[2];       ///< Equations of the vessels
+  std::vector<int> slot_ids[3];      ///< Solution-dependent matrix slots
+
+  // Work arrays of the vessels with stenosis
+  Eigen::ArrayXd stenosis_coeff;       ///< Stenosis coefficients
+  Eigen::ArrayXd capacitance;          ///< Capacitances
+  Eigen::ArrayXd q_in;                 ///< Inflows
+  Eigen::ArrayXd dq_in;                ///< Time derivatives of the inflows
+  Eigen::ArrayXd stenosis_resistance;  ///< Stenosis resistances
+  Eigen::ArrayXd sgn_q_in;             ///< Signs of the inflows
+  Eigen::ArrayXd c[2];                 ///< Entries of C
+  Eigen::ArrayXd slot_values[3];       ///< Values of the slots
+
+  /**
+   * @brief Reset the contributions of all vessels without stenosis
+   *
+   * @param system System to reset contributions at
+   */
+  void reset_contributions(SparseSystem &system);
+};
+
+#endif  // SVZERODSOLVER_MODEL_BLOODVESSELBATCH_HPP_
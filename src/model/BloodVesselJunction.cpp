@@ -43,6 +43,13 @@ void BloodVesselJunction::setup_dofs(DOFHandler &dofhandler) {
   num_triplets.D = 2 * num_outlets;
 }
 
+void BloodVesselJunction::setup_slots() {
+  for (size_t i = 0; i < num_outlets; i++) {
+    register_slot(SystemMatrix::dC_dy, global_eqn_ids[i + 1],
+                  global_var_ids[3 + 2 * i]);
+  }
+}
+
 void BloodVesselJunction::update_constant(SparseSystem &system,
                                           std::vector<double> &parameters) {
   // Mass conservation
@@ -74,8 +81,7 @@ void BloodVesselJunction::update_solution(
 
     // Mass conservation
     system.C(global_eqn_ids[i + 1]) = -stenosis_resistance * q_out;
-    system.dC_dy.coeffRef(global_eqn_ids[i + 1], global_var_ids[3 + 2 * i]) =
-        -2.0 * stenosis_resistance;
+    system.slot(global_slot_ids[i]) = -2.0 * stenosis_resistance;
   }
 }
 
@@ -121,3 +127,5 @@ void BloodVesselJunction::update_gradient(
         inductance * dq_out;
   }
 }
+
+int BloodVesselJunction::get_dependencies() { return SOLUTION_DEPENDENT; }
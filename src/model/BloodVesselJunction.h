@@ -142,7 +142,7 @@
  * * `i+2*num_outlets` Stenosis coefficient for inner blood vessel `i`
  *
  */
-class BloodVesselJunction : public Block {
+class BloodVesselJunction final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -159,6 +159,13 @@ class BloodVesselJunction : public Block {
    */
   void setup_dofs(DOFHandler &dofhandler);
 
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse system
    *
@@ -196,6 +203,13 @@ class BloodVesselJunction : public Block {
                        Eigen::Matrix<double, Eigen::Dynamic, 1> &alpha,
                        std::vector<double> &y, std::vector<double> &dy);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
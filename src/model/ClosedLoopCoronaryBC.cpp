@@ -86,3 +86,5 @@ void ClosedLoopCoronaryBC::update_solution(
   auto pim = im * y[ventricle_var_id];
   system.C(global_eqn_ids[2]) = -cim * pim;
 }
+
+int ClosedLoopCoronaryBC::get_dependencies() { return SOLUTION_DEPENDENT; }
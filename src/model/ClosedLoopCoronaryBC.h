@@ -120,7 +120,7 @@ enum class Side { LEFT, RIGHT, NONE };
  * * `4` Cim
  *
  */
-class ClosedLoopCoronaryBC : public Block {
+class ClosedLoopCoronaryBC final : public Block {
  public:
   /**
    * @brief Construct a ClosedLoopCoronaryBC object.
@@ -179,6 +179,13 @@ class ClosedLoopCoronaryBC : public Block {
                        const Eigen::Matrix<double, Eigen::Dynamic, 1> &y,
                        const Eigen::Matrix<double, Eigen::Dynamic, 1> &dy);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
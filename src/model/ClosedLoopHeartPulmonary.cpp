@@ -38,6 +38,31 @@ void ClosedLoopHeartPulmonary::setup_dofs(DOFHandler &dofhandler) {
                       "V_LA", "Q_LA", "P_LV", "V_LV", "Q_LV"});
 }
 
+void ClosedLoopHeartPulmonary::setup_slots() {
+  // Time-dependent elastances (update_time)
+  register_slot(SystemMatrix::F, global_eqn_ids[0], global_var_ids[4]);
+  register_slot(SystemMatrix::F, global_eqn_ids[4], global_var_ids[7]);
+  register_slot(SystemMatrix::F, global_eqn_ids[8], global_var_ids[11]);
+  register_slot(SystemMatrix::F, global_eqn_ids[11], global_var_ids[14]);
+
+  // Solution-dependent atrium pressures and valves (update_solution)
+  register_slot(SystemMatrix::dC_dy, global_eqn_ids[0], global_var_ids[4]);
+  register_slot(SystemMatrix::dC_dy, global_eqn_ids[8], global_var_ids[11]);
+  register_slot(SystemMatrix::F, global_eqn_ids[1], global_var_ids[15]);
+  register_slot(SystemMatrix::F, global_eqn_ids[7], global_var_ids[8]);
+  register_slot(SystemMatrix::F, global_eqn_ids[2], global_var_ids[5]);
+  register_slot(SystemMatrix::F, global_eqn_ids[5], global_var_ids[5]);
+  register_slot(SystemMatrix::F, global_eqn_ids[5], global_var_ids[8]);
+  register_slot(SystemMatrix::F, global_eqn_ids[9], global_var_ids[8]);
+  register_slot(SystemMatrix::F, global_eqn_ids[9], global_var_ids[12]);
+  register_slot(SystemMatrix::F, global_eqn_ids[12], global_var_ids[12]);
+  register_slot(SystemMatrix::F, global_eqn_ids[12], global_var_ids[15]);
+  register_slot(SystemMatrix::F, global_eqn_ids[3], global_var_ids[5]);
+  register_slot(SystemMatrix::F, global_eqn_ids[6], global_var_ids[8]);
+  register_slot(SystemMatrix::F, global_eqn_ids[10], global_var_ids[12]);
+  register_slot(SystemMatrix::F, global_eqn_ids[13], global_var_ids[15]);
+}
+
 void ClosedLoopHeartPulmonary::update_constant(
     SparseSystem &system, std::vector<double> &parameters) {
   // DOF 0, Eq 0: Right atrium pressure
@@ -108,20 +133,20 @@ void ClosedLoopHeartPulmonary::update_time(SparseSystem &system,
   get_activation_and_elastance_functions(parameters);
 
   // DOF 0, Eq 0: Right atrium pressure
-  system.F.coeffRef(global_eqn_ids[0], global_var_ids[4]) =
+  system.slot(global_slot_ids[0]) =
       -AA * parameters[global_param_ids[ParamId::EMAX_RA]];
 
   // DOF 6, Eq 4: Right ventricle pressure
-  system.F.coeffRef(global_eqn_ids[4], global_var_ids[7]) = -Erv;
+  system.slot(global_slot_ids[1]) = -Erv;
   system.C(global_eqn_ids[4]) =
       Erv * parameters[global_param_ids[ParamId::VRV_U]];
 
   // DOF 10, Eq 8: Left atrium pressure
-  system.F.coeffRef(global_eqn_ids[8], global_var_ids[11]) =
+  system.slot(global_slot_ids[2]) =
       -AA * parameters[global_param_ids[ParamId::EMAX_LA]];
 
   // DOF 13, Eq 11: Left ventricle pressure
-  system.F.coeffRef(global_eqn_ids[11], global_var_ids[14]) = -Elv;
+  system.slot(global_slot_ids[3]) = -Elv;
   system.C(global_eqn_ids[11]) =
       Elv * parameters[global_param_ids[ParamId::VLV_U]];
 }
@@ -147,52 +172,50 @@ void ClosedLoopHeartPulmonary::update_solution(
       AA * parameters[global_param_ids[ParamId::EMAX_RA]] *
           parameters[global_param_ids[ParamId::VASO_RA]] +
       psi_ra * (AA - 1.0);
-  system.dC_dy.coeffRef(global_eqn_ids[0], global_var_ids[4]) =
-      psi_ra_derivative * (AA - 1.0);
+  system.slot(global_slot_ids[4]) = psi_ra_derivative * (AA - 1.0);
 
   // DOF 10, Eq 8: Left atrium pressure
   system.C(global_eqn_ids[8]) =
       AA * parameters[global_param_ids[ParamId::EMAX_LA]] *
           parameters[global_param_ids[ParamId::VASO_LA]] +
       psi_la * (AA - 1.0);
-  system.dC_dy.coeffRef(global_eqn_ids[8], global_var_ids[11]) =
-      psi_la_derivative * (AA - 1.0);
+  system.slot(global_slot_ids[5]) = psi_la_derivative * (AA - 1.0);
 
   // DOF 2, Eq 1: Aortic pressure
-  system.F.coeffRef(global_eqn_ids[1], global_var_ids[15]) = -valves[15];
+  system.slot(global_slot_ids[6]) = -valves[15];
 
   // DOF 9, Eq 7: Pulmonary pressure
-  system.F.coeffRef(global_eqn_ids[7], global_var_ids[8]) = -valves[8];
+  system.slot(global_slot_ids[7]) = -valves[8];
 
   // DOF 4, Eq 2: Right atrium volume
-  system.F.coeffRef(global_eqn_ids[2], global_var_ids[5]) = valves[5];
+  system.slot(global_slot_ids[8]) = valves[5];
 
   // DOF 7, Eq 5: Right ventricle volume
-  system.F.coeffRef(global_eqn_ids[5], global_var_ids[5]) = -valves[5];
-  system.F.coeffRef(global_eqn_ids[5], global_var_ids[8]) = valves[8];
+  system.slot(global_slot_ids[9]) = -valves[5];
+  system.slot(global_slot_ids[10]) = valves[8];
 
   // DOF 11, Eq 9: Left atrium volume
-  system.F.coeffRef(global_eqn_ids[9], global_var_ids[8]) = -valves[8];
-  system.F.coeffRef(global_eqn_ids[9], global_var_ids[12]) = valves[12];
+  system.slot(global_slot_ids[11]) = -valves[8];
+  system.slot(global_slot_ids[12]) = valves[12];
 
   // DOF 14, Eq 12: Left ventricle volume
-  system.F.coeffRef(global_eqn_ids[12], global_var_ids[12]) = -valves[12];
-  system.F.coeffRef(global_eqn_ids[12], global_var_ids[15]) = valves[15];
+  system.slot(global_slot_ids[13]) = -valves[12];
+  system.slot(global_slot_ids[14]) = valves[15];
 
   // DOF 5, Eq 3: Right atrium outflow
-  system.F.coeffRef(global_eqn_ids[3], global_var_ids[5]) =
+  system.slot(global_slot_ids[15]) =
       parameters[global_param_ids[ParamId::RRA_V]] * valves[5];
 
   // DOF 8, Eq 6: Right ventricle outflow
-  system.F.coeffRef(global_eqn_ids[6], global_var_ids[8]) =
+  system.slot(global_slot_ids[16]) =
       parameters[global_param_ids[ParamId::RRV_A]] * valves[8];
 
   // DOF 12, Eq 10: Left atrium outflow
-  system.F.coeffRef(global_eqn_ids[10], global_var_ids[12]) =
+  system.slot(global_slot_ids[17]) =
       parameters[global_param_ids[ParamId::RLA_V]] * valves[12];
 
   // DOF 15, Eq 13: Left ventricle outflow
-  system.F.coeffRef(global_eqn_ids[13], global_var_ids[15]) =
+  system.slot(global_slot_ids[18]) =
       parameters[global_param_ids[ParamId::RLV_AO]] * valves[15];
 }
 
@@ -311,4 +334,8 @@ void ClosedLoopHeartPulmonary::post_solve(
     Eigen::Matrix<double, Eigen::Dynamic, 1> &y) {
   for (size_t i = 0; i < 16; i++)
     if (valves[i] < 0.5) y[global_var_ids[i]] = 0.0;
-}
\ No newline at end of file
+}
+
+int ClosedLoopHeartPulmonary::get_dependencies() {
+  return TIME_DEPENDENT | SOLUTION_DEPENDENT | POST_SOLVE;
+}
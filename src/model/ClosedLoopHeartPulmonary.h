@@ -91,7 +91,7 @@
  * * `26` Left atrium resting volume
  *
  */
-class ClosedLoopHeartPulmonary : public Block {
+class ClosedLoopHeartPulmonary final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -142,6 +142,13 @@ class ClosedLoopHeartPulmonary : public Block {
    */
   void setup_dofs(DOFHandler &dofhandler);
 
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse
    system
@@ -180,6 +187,13 @@ class ClosedLoopHeartPulmonary : public Block {
    */
   void post_solve(Eigen::Matrix<double, Eigen::Dynamic, 1> &y);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
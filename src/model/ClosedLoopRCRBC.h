@@ -108,7 +108,7 @@
  * * `2` Distal resistance
  *
  */
-class ClosedLoopRCRBC : public Block {
+class ClosedLoopRCRBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -144,6 +144,13 @@ class ClosedLoopRCRBC : public Block {
    */
   void update_constant(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
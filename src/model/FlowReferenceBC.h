@@ -78,7 +78,7 @@
  * * `0` Flow
  *
  */
-class FlowReferenceBC : public Block {
+class FlowReferenceBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -112,6 +112,13 @@ class FlowReferenceBC : public Block {
    */
   void update_time(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
@@ -70,3 +70,5 @@ void Junction::update_gradient(
 
   residual(global_eqn_ids[1]) = y[global_var_ids[1]] - y[global_var_ids[3]];
 }
+
+int Junction::get_dependencies() { return CONSTANT; }
@@ -85,7 +85,7 @@
  * \quad \mathrm{with} \quad i \neq j \f]
  *
  */
-class Junction : public Block {
+class Junction final : public Block {
  public:
   using Block::Block;
 
@@ -124,6 +124,13 @@ class Junction : public Block {
                        Eigen::Matrix<double, Eigen::Dynamic, 1> &alpha,
                        std::vector<double> &y, std::vector<double> &dy);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
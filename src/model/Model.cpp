@@ -178,7 +178,8 @@ int Model::add_parameter(double value) {
 
 int Model::add_parameter(const std::vector<double> &times,
                          const std::vector<double> &values, bool periodic) {
-  auto param = Parameter(parameter_count, times, values, periodic);
+  auto param = Parameter(parameter_count, times, values, periodic,
+                         parameter_interpolation);
   if (periodic && (param.is_constant == false)) {
     if ((this->cardiac_cycle_period > 0.0) &&
         (param.cycle_period != this->cardiac_cycle_period)) {
@@ -194,6 +195,8 @@ int Model::add_parameter(const std::vector<double> &times,
 
 Parameter *Model::get_parameter(int param_id) { return &parameters[param_id]; }
 
+int Model::get_num_parameters() const { return parameter_count; }
+
 double Model::get_parameter_value(int param_id) const {
   return parameter_values[param_id];
 }
@@ -202,6 +205,15 @@ void Model::update_parameter_value(int param_id, double param_value) {
   parameter_values[param_id] = param_value;
 }
 
+void Model::set_parameter_changed(int param_id) {
+  for (int block_id : parameter_blocks[param_id]) {
+    if (!block_changed[block_id]) {
+      block_changed[block_id] = true;
+      changed_blocks.push_back(block_id);
+    }
+  }
+}
+
 void Model::finalize() {
   // DEBUG_MSG("Setup degrees-of-freedom of nodes");
   for (auto &node : nodes) {
@@ -215,10 +227,68 @@ void Model::finalize() {
   for (auto &block : blocks) {
     block->setup_model_dependent_params();
   }
+  // DEBUG_MSG("Setup system matrix slots of blocks");
+  for (auto &block : blocks) {
+    block->setup_slots();
+  }
 
   if (cardiac_cycle_period < 0.0) {
     cardiac_cycle_period = 1.0;
   }
+
+  // Blocks that use each parameter (for updates of single parameters)
+  parameter_blocks.assign(parameters.size(), {});
+  for (size_t i = 0; i < blocks.size(); i++) {
+    for (int param_id : blocks[i]->global_param_ids) {
+      parameter_blocks[param_id].push_back(i);
+    }
+  }
+  changed_blocks.clear();
+  block_changed.assign(blocks.size(), false);
+
+  // Blocks grouped by type for the assembly of the system. The phases of the
+  // assembly only visit the blocks that contribute in them.
+  auto add_to_groups = [](std::vector<BlockGroup> &groups, BlockType type,
+                          Block *block) {
+    auto group = std::find_if(
+        groups.begin(), groups.end(),
+        [type](const BlockGroup &group) { return group.type == type; });
+    if (group == groups.end()) {
+      groups.push_back({type, {}});
+      group = groups.end() - 1;
+    }
+    group->blocks.push_back(block);
+  };
+  block_groups.clear();
+  time_groups.clear();
+  solution_groups.clear();
+  post_solve_groups.clear();
+  for (auto &block : blocks) {
+    auto type = block_types[block->id];
+    int dependencies = block->get_dependencies();
+    add_to_groups(block_groups, type, block.get());
+    if (dependencies & Block::TIME_DEPENDENT) {
+      add_to_groups(time_groups, type, block.get());
+    }
+    // The blood vessels are evaluated together in vessel_batch
+    if ((dependencies & Block::SOLUTION_DEPENDENT) &&
+        (type != BlockType::blood_vessel)) {
+      add_to_groups(solution_groups, type, block.get());
+    }
+    if (dependencies & Block::POST_SOLVE) {
+      add_to_groups(post_solve_groups, type, block.get());
+    }
+  }
+  vessel_batch.setup({});
+  for (auto &group : block_groups) {
+    if (group.type == BlockType::blood_vessel) {
+      vessel_batch.setup(group.blocks);
+    }
+  }
+
+  // The degrees-of-freedom and slots of the blocks may have changed
+  system_patterns[0].reset();
+  system_patterns[1].reset();
 }
 
 int Model::get_num_blocks(bool internal) const {
@@ -231,10 +301,85 @@ int Model::get_num_blocks(bool internal) const {
   return num_blocks;
 }
 
+int Model::register_slot(SystemMatrix matrix, int row, int col) {
+  slots.push_back({matrix, row, col});
+  return slots.size() - 1;
+}
+
+const std::vector<SystemSlot> &Model::get_slots() const { return slots; }
+
+template <typename BlockClass, typename Function>
+void Model::visit_group(const std::vector<Block *> &blocks,
+                        Function &function) {
+  for (Block *block : blocks) {
+    function(static_cast<BlockClass *>(block));
+  }
+}
+
+template <typename Function>
+void Model::visit_blocks(const std::vector<BlockGroup> &groups,
+                         Function &&function) {
+  for (auto &group : groups) {
+    switch (group.type) {
+      case BlockType::blood_vessel:
+        visit_group<BloodVessel>(group.blocks, function);
+        break;
+      case BlockType::junction:
+        visit_group<Junction>(group.blocks, function);
+        break;
+      case BlockType::blood_vessel_junction:
+        visit_group<BloodVesselJunction>(group.blocks, function);
+        break;
+      case BlockType::resistive_junction:
+        visit_group<ResistiveJunction>(group.blocks, function);
+        break;
+      case BlockType::flow_bc:
+        visit_group<FlowReferenceBC>(group.blocks, function);
+        break;
+      case BlockType::pressure_bc:
+        visit_group<PressureReferenceBC>(group.blocks, function);
+        break;
+      case BlockType::resistnce_bc:
+        visit_group<ResistanceBC>(group.blocks, function);
+        break;
+      case BlockType::windkessel_bc:
+        visit_group<WindkesselBC>(group.blocks, function);
+        break;
+      case BlockType::open_loop_coronary_bc:
+        visit_group<OpenLoopCoronaryBC>(group.blocks, function);
+        break;
+      case BlockType::closed_loop_coronary_lefT_bc:
+      case BlockType::closed_loop_coronary_right_bc:
+        visit_group<ClosedLoopCoronaryBC>(group.blocks, function);
+        break;
+      case BlockType::closed_loop_rcr_bc:
+        visit_group<ClosedLoopRCRBC>(group.blocks, function);
+        break;
+      case BlockType::closed_loop_heart_pulmonary:
+        visit_group<ClosedLoopHeartPulmonary>(group.blocks, function);
+        break;
+      default:
+        visit_group<Block>(group.blocks, function);
+    }
+  }
+}
+
 void Model::update_constant(SparseSystem &system) {
-  for (auto block : blocks) {
+  visit_blocks(block_groups, [&](auto *block) {
     block->update_constant(system, parameter_values);
+  });
+}
+
+bool Model::update_changed_constant(SparseSystem &system) {
+  if (changed_blocks.empty()) {
+    return false;
+  }
+  for (int block_id : changed_blocks) {
+    blocks[block_id]->update_constant(system, parameter_values);
+    block_changed[block_id] = false;
   }
+  changed_blocks.clear();
+  return true;
 }
 
 void Model::update_time(SparseSystem &system, double time) {
@@ -244,26 +389,28 @@ void Model::update_time(SparseSystem &system, double time) {
     parameter_values[param.id] = param.get(time);
   }
 
-  for (auto block : blocks) {
+  visit_blocks(time_groups, [&](auto *block) {
     block->update_time(system, parameter_values);
-  }
+  });
+  vessel_batch.update_time(system, parameter_values);
 }
 
 void Model::update_solution(SparseSystem &system,
                             Eigen::Matrix<double, Eigen::Dynamic, 1> &y,
                             Eigen::Matrix<double, Eigen::Dynamic, 1> &dy) {
-  for (auto block : blocks) {
+  vessel_batch.update_solution(system, parameter_values, y, dy);
+  visit_blocks(solution_groups, [&](auto *block) {
     block->update_solution(system, parameter_values, y, dy);
-  }
+  });
 }
 
 void Model::post_solve(Eigen::Matrix<double, Eigen::Dynamic, 1> &y) {
-  for (auto block : blocks) {
-    block->post_solve(y);
-  }
+  visit_blocks(post_solve_groups,
+               [&](auto *block) { block->post_solve(y); });
 }
 
 void Model::to_steady() {
+  steady = true;
   for (auto &param : parameters) {
     param.to_steady();
   }
@@ -281,6 +428,7 @@ void Model::to_steady() {
 }
 
 void Model::to_unsteady() {
+  steady = false;
   for (auto &param : parameters) {
     param.to_unsteady();
   }
@@ -302,3 +450,11 @@ TripletsContributions Model::get_num_triplets() const {
 
   return triplets_sum;
 }
+
+std::shared_ptr<SystemPattern> Model::get_system_pattern() const {
+  return system_patterns[steady];
+}
+
+void Model::set_system_pattern(std::shared_ptr<SystemPattern> pattern) {
+  system_patterns[steady] = pattern;
+}
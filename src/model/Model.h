@@ -44,6 +44,7 @@
 
 #include "Block.h"
 #include "BloodVessel.h"
+#include "BloodVesselBatch.h"
 #include "BloodVesselJunction.h"
 #include "ClosedLoopCoronaryBC.h"
 #include "ClosedLoopHeartPulmonary.h"
@@ -84,6 +85,8 @@ class Model {
 
   double cardiac_cycle_period = -1.0;  ///< Cardiac cycle period
   double time = 0.0;                   ///< Current time
+  InterpolationType parameter_interpolation =
+      InterpolationType::linear;  ///< Interpolation of periodic parameters
 
   /**
    * @brief Add a block to the model
@@ -176,6 +179,13 @@ class Model {
    */
   Parameter *get_parameter(int param_id);
 
+  /**
+   * @brief Get the number of parameters in the model
+   *
+   * @return int Number of parameters
+   */
+  int get_num_parameters() const;
+
   /**
    * @brief Get the current value of a parameter
    *
@@ -192,6 +202,16 @@ class Model {
    */
   void update_parameter_value(int param_id, double param_value);
 
+  /**
+   * @brief Mark a parameter as changed
+   *
+   * The constant contributions of the blocks that use the parameter are
+   * updated by the next call of update_changed_constant().
+   *
+   * @param param_id Global ID of the parameter
+   */
+  void set_parameter_changed(int param_id);
+
   /**
    * @brief Finalize the model after all blocks, nodes and parameters have been
    * added
@@ -206,6 +226,15 @@ class Model {
    */
   void update_constant(SparseSystem &system);
 
+  /**
+   * @brief Update the constant contributions of the elements with changed
+   * parameters (see set_parameter_changed()) in a sparse system
+   *
+   * @param system System to update contributions at
+   * @return Whether any contributions were updated
+   */
+  bool update_changed_constant(SparseSystem &system);
+
   /**
    * @brief Update the time-dependent contributions of all elements in a sparse
    * system
@@ -266,7 +295,77 @@ class Model {
    */
   int get_num_blocks(bool internal = false) const;
 
+  /**
+   * @brief Register an entry of a system matrix that is updated repeatedly
+   *
+   * @param matrix System matrix of the entry
+   * @param row Row of the entry
+   * @param col Column of the entry
+   * @return int Global ID of the slot
+   */
+  int register_slot(SystemMatrix matrix, int row, int col);
+
+  /**
+   * @brief Get the registered entries of the system matrices
+   *
+   * @return Registered entries ordered by their global ID
+   */
+  const std::vector<SystemSlot> &get_slots() const;
+
+  /**
+   * @brief Get the cached pattern of the system of the model
+   *
+   * Blocks may assemble different entries in steady and unsteady behavior.
+   * Therefore, a pattern is cached for each behavior.
+   *
+   * @return Cached pattern for the current behavior of the blocks (nullptr if
+   * no pattern was computed yet)
+   */
+  std::shared_ptr<SystemPattern> get_system_pattern() const;
+
+  /**
+   * @brief Cache the pattern of the system of the model
+   *
+   * @param pattern Pattern for the current behavior of the blocks
+   */
+  void set_system_pattern(std::shared_ptr<SystemPattern> pattern);
+
  private:
+  /**
+   * @brief Blocks of one type
+   */
+  struct BlockGroup {
+    BlockType type;               ///< Type of the blocks
+    std::vector<Block *> blocks;  ///< Blocks of this type
+  };
+
+  /**
+   * @brief Call a function for all blocks of one group
+   *
+   * The blocks are passed as pointers to their final class, so the calls of
+   * the block methods in the function are not virtual.
+   *
+   * @tparam BlockClass Class of the blocks in the group
+   * @tparam Function Type of the function
+   * @param blocks Blocks of the group
+   * @param function Function that is called with each block
+   */
+  template <typename BlockClass, typename Function>
+  static void visit_group(const std::vector<Block *> &blocks,
+                          Function &function);
+
+  /**
+   * @brief Call a function for all blocks in a list of groups, one type at a
+   * time
+   *
+   * @tparam Function Type of the function
+   * @param groups Groups of blocks
+   * @param function Generic function that is called with each block
+   */
+  template <typename Function>
+  static void visit_blocks(const std::vector<BlockGroup> &groups,
+                           Function &&function);
+
   int block_count = 0;
   int node_count = 0;
   int parameter_count = 0;
@@ -281,11 +380,31 @@ class Model {
   std::vector<std::shared_ptr<Block>>
       hidden_blocks;  ///< Hidden blocks of the model
 
+  std::vector<BlockGroup> block_groups;  ///< Blocks grouped by their type
+  std::vector<BlockGroup> time_groups;   ///< Time-dependent blocks
+  std::vector<BlockGroup>
+      solution_groups;  ///< Solution-dependent blocks (except blood vessels)
+  std::vector<BlockGroup>
+      post_solve_groups;  ///< Blocks that modify the solution after solving
+  BloodVesselBatch vessel_batch;  ///< Batched evaluation of the vessels
+
   std::vector<std::shared_ptr<Node>> nodes;  ///< Nodes of the model
   std::vector<std::string> node_names;       ///< Names of the nodes
 
   std::vector<Parameter> parameters;     ///< Parameters of the model
   std::vector<double> parameter_values;  ///< Current values of the parameters
+  std::vector<std::vector<int>>
+      parameter_blocks;  ///< Blocks that use each parameter
+  std::vector<int> changed_blocks;  ///< Blocks with changed parameters
+  std::vector<bool> block_changed;  ///< Whether the parameters of each block
+                                    ///< changed
+
+  std::vector<SystemSlot> slots;  ///< Registered entries of system matrices
+
+  bool steady = false;  ///< Whether the blocks have a steady behavior
+  std::shared_ptr<SystemPattern>
+      system_patterns[2];  ///< Cached system patterns for the unsteady and the
+                           ///< steady behavior
 };
 
 #endif  // SVZERODSOLVER_MODEL_MODEL_HPP_
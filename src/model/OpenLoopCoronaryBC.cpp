@@ -81,3 +81,5 @@ void OpenLoopCoronaryBC::update_time(SparseSystem &system,
     system.C(global_eqn_ids[1]) = -Cim * (Rv + Ram) * Pim + Ram * Cim * Pv;
   }
 }
+
+int OpenLoopCoronaryBC::get_dependencies() { return TIME_DEPENDENT; }
@@ -104,7 +104,7 @@
  * * `6` Pv
  *
  */
-class OpenLoopCoronaryBC : public Block {
+class OpenLoopCoronaryBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -138,6 +138,13 @@ class OpenLoopCoronaryBC : public Block {
    */
   void update_time(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
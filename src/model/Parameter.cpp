@@ -30,15 +30,20 @@
 
 #include "Parameter.h"
 
+#include <algorithm>
+#include <cmath>
+
 Parameter::Parameter(int id, double value) {
   this->id = id;
   update(value);
 }
 
 Parameter::Parameter(int id, const std::vector<double> &times,
-                     const std::vector<double> &values, bool periodic) {
+                     const std::vector<double> &values, bool periodic,
+                     InterpolationType interpolation) {
   this->id = id;
   this->is_periodic = periodic;
+  this->interpolation = interpolation;
   update(times, values);
 }
 
@@ -60,9 +65,188 @@ void Parameter::update(const std::vector<double> &update_times,
     values = update_values;
     cycle_period = update_times.back() - update_times[0];
     is_constant = false;
+    setup_interval_search();
+    setup_slopes();
+  }
+}
+
+void Parameter::update(const double *update_times,
+                       const double *update_values, int update_size) {
+  this->size = update_size;
+
+  if (size == 1) {
+    value = update_values[0];
+    is_constant = true;
+  } else {
+    times.assign(update_times, update_times + size);
+    values.assign(update_values, update_values + size);
+    cycle_period = times.back() - times[0];
+    is_constant = false;
+    setup_interval_search();
+    setup_slopes();
+  }
+}
+
+bool Parameter::has_time_series(const double *other_times,
+                                const double *other_values,
+                                int other_size) const {
+  return (times.size() == size_t(other_size)) &&
+         (values.size() == size_t(other_size)) &&
+         std::equal(times.begin(), times.end(), other_times) &&
+         std::equal(values.begin(), values.end(), other_values);
+}
+
+void Parameter::setup_interval_search() {
+  cursor = 0;
+
+  // Check if the time steps are equidistant
+  int n = times.size();
+  double time_step = (times.back() - times[0]) / double(n - 1);
+  is_uniform = time_step > 0.0;
+  for (int i = 1; (i < n) && is_uniform; i++) {
+    is_uniform = std::abs(times[i] - (times[0] + double(i) * time_step)) <=
+                 1.0e-8 * time_step;
+  }
+  inverse_time_step = is_uniform ? 1.0 / time_step : 0.0;
+}
+
+/**
+ * @brief Solve a cyclic tridiagonal system of equations
+ *
+ * Solves lower[i] * x[i-1] + diag[i] * x[i] + upper[i] * x[i+1] = rhs[i] with
+ * cyclic indices (Thomas algorithm with Sherman-Morrison correction for the
+ * corner entries, requires at least three equations).
+ *
+ * @param lower Lower diagonal
+ * @param diag Diagonal (modified)
+ * @param upper Upper diagonal
+ * @param rhs Right-hand side (overwritten with the solution)
+ */
+static void solve_cyclic_tridiagonal(const std::vector<double> &lower,
+                                     std::vector<double> &diag,
+                                     const std::vector<double> &upper,
+                                     std::vector<double> &rhs) {
+  int n = rhs.size();
+  double gamma = -diag[0];
+  double alpha = lower[0];
+  double beta = upper[n - 1];
+  diag[0] -= gamma;
+  diag[n - 1] -= alpha * beta / gamma;
+
+  // Solve the tridiagonal system for the right-hand side and the correction
+  std::vector<double> u(n, 0.0);
+  u[0] = gamma;
+  u[n - 1] = beta;
+  std::vector<double> c(n);
+  c[0] = upper[0] / diag[0];
+  rhs[0] /= diag[0];
+  u[0] /= diag[0];
+  for (int i = 1; i < n; i++) {
+    double denominator = diag[i] - lower[i] * c[i - 1];
+    c[i] = upper[i] / denominator;
+    rhs[i] = (rhs[i] - lower[i] * rhs[i - 1]) / denominator;
+    u[i] = (u[i] - lower[i] * u[i - 1]) / denominator;
+  }
+  for (int i = n - 2; i >= 0; i--) {
+    rhs[i] -= c[i] * rhs[i + 1];
+    u[i] -= c[i] * u[i + 1];
+  }
+
+  // Sherman-Morrison correction
+  double factor = (rhs[0] + alpha * rhs[n - 1] / gamma) /
+                  (1.0 + u[0] + alpha * u[n - 1] / gamma);
+  for (int i = 0; i < n; i++) {
+    rhs[i] -= factor * u[i];
   }
 }
 
+void Parameter::setup_slopes() {
+  int n = times.size();
+  if ((interpolation == InterpolationType::linear) || !is_periodic ||
+      (n < 4)) {
+    slopes.clear();
+    return;
+  }
+
+  // The last time step is the first time step of the next cycle, so there are
+  // num_intervals independent slopes
+  int num_intervals = n - 1;
+  std::vector<double> h(num_intervals);
+  std::vector<double> delta(num_intervals);
+  for (int i = 0; i < num_intervals; i++) {
+    h[i] = times[i + 1] - times[i];
+    delta[i] = (values[i + 1] - values[i]) / h[i];
+  }
+  slopes.resize(n);
+
+  for (int i = 0; i < num_intervals; i++) {
+    int prev = (i + num_intervals - 1) % num_intervals;
+    if (interpolation == InterpolationType::pchip) {
+      // Weighted harmonic mean of the neighboring secants (Fritsch-Carlson),
+      // zero at local extrema
+      if (delta[prev] * delta[i] <= 0.0) {
+        slopes[i] = 0.0;
+      } else {
+        double w1 = 2.0 * h[i] + h[prev];
+        double w2 = h[i] + 2.0 * h[prev];
+        slopes[i] = (w1 + w2) / (w1 / delta[prev] + w2 / delta[i]);
+      }
+    }
+  }
+
+  if (interpolation == InterpolationType::periodic_spline) {
+    // Continuous second derivatives at all time steps
+    std::vector<double> lower(num_intervals);
+    std::vector<double> diag(num_intervals);
+    std::vector<double> upper(num_intervals);
+    for (int i = 0; i < num_intervals; i++) {
+      int prev = (i + num_intervals - 1) % num_intervals;
+      lower[i] = h[i];
+      diag[i] = 2.0 * (h[prev] + h[i]);
+      upper[i] = h[prev];
+      slopes[i] = 3.0 * (h[i] * delta[prev] + h[prev] * delta[i]);
+    }
+    slopes.resize(num_intervals);
+    solve_cyclic_tridiagonal(lower, diag, upper, slopes);
+    slopes.resize(n);
+  }
+  slopes[n - 1] = slopes[0];
+}
+
+int Parameter::find_interval(double time) {
+  int n = times.size();
+  auto is_interval = [&](int k) {
+    return ((k == 0) || (times[k - 1] < time)) &&
+           ((k == n) || (times[k] >= time));
+  };
+
+  // Time advanced by at most one time step since the last call or restarted
+  // at the beginning of a periodic time series
+  for (int k : {cursor, cursor + 1, 0, 1}) {
+    if ((k <= n) && is_interval(k)) {
+      cursor = k;
+      return k;
+    }
+  }
+
+  if (is_uniform) {
+    // Compute the index directly and correct it for rounding errors
+    double position = std::ceil((time - times[0]) * inverse_time_step);
+    int k = int(std::min(std::max(position, 0.0), double(n)));
+    while ((k > 0) && (times[k - 1] >= time)) {
+      k--;
+    }
+    while ((k < n) && (times[k] < time)) {
+      k++;
+    }
+    cursor = k;
+  } else {
+    cursor =
+        std::lower_bound(times.begin(), times.end(), time) - times.begin();
+  }
+  return cursor;
+}
+
 double Parameter::get(double time) {
   // Return the constant value if parameter is constant
   if (is_constant) {
@@ -80,18 +264,25 @@ double Parameter::get(double time) {
   }
 
   // Determine the lower and upper element for interpolation
-  auto i = lower_bound(times.begin(), times.end(), rtime);
-  int k = i - times.begin();
+  int k = find_interval(rtime);
 
-  if (i == times.end()) {
-    --i;
-  } else if (*i == rtime) {
+  if (k == int(times.size())) {
+    --k;
+  } else if (times[k] == rtime) {
     return values[k];
   }
   int m = k ? k - 1 : 1;
 
+  // Perform cubic Hermite interpolation within the time series
+  if (!slopes.empty() && (k > 0) && (rtime < times[k])) {
+    double h = times[k] - times[m];
+    double s = (rtime - times[m]) / h;
+    double r = 1.0 - s;
+    return values[m] * (1.0 + 2.0 * s) * r * r + slopes[m] * h * s * r * r +
+           values[k] * s * s * (3.0 - 2.0 * s) - slopes[k] * h * s * s * r;
+  }
+
   // Perform linear interpolation
-  // TODO: Implement periodic cubic spline
   return values[m] +
          ((values[k] - values[m]) / (times[k] - times[m])) * (rtime - times[m]);
 }
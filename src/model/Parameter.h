@@ -41,6 +41,15 @@
 
 #include "DOFHandler.h"
 
+/**
+ * @brief Interpolation of time-dependent parameters
+ */
+enum class InterpolationType {
+  linear = 0,           ///< Piecewise linear interpolation
+  periodic_spline = 1,  ///< Periodic cubic spline
+  pchip = 2             ///< Periodic monotone piecewise cubic Hermite
+};
+
 /**
  * @brief Model Parameter.
  *
@@ -65,9 +74,11 @@ class Parameter {
    * @param times Time steps corresponding to the time-dependent values
    * @param values Values corresponding to the time steps
    * @param periodic Is this parameter periodic with a cardiac cycle?
+   * @param interpolation Interpolation between the time steps
    */
   Parameter(int id, const std::vector<double>& times,
-            const std::vector<double>& values, bool periodic = true);
+            const std::vector<double>& values, bool periodic = true,
+            InterpolationType interpolation = InterpolationType::linear);
 
   int id;                      ///< Global ID of the parameter
   std::vector<double> times;   ///< Time steps if parameter is time-dependent
@@ -79,6 +90,8 @@ class Parameter {
   bool is_constant;  ///< Bool value indicating if the parameter is constant
   bool is_periodic;  ///< Bool value indicating if the parameter is periodic
                      ///< with the cardiac cycle
+  InterpolationType interpolation =
+      InterpolationType::linear;  ///< Interpolation between the time steps
 
   /**
    * @brief Update the parameter
@@ -96,6 +109,31 @@ class Parameter {
   void update(const std::vector<double>& times,
               const std::vector<double>& values);
 
+  /**
+   * @brief Update the parameter from raw arrays
+   *
+   * The time series is copied into the existing storage, so repeated updates
+   * with the same number of time steps do not allocate memory. This is used
+   * for the short time series that an external solver passes in each
+   * coupling step.
+   *
+   * @param times Time steps corresponding to the values
+   * @param values Values correspondong to the time steps
+   * @param size Number of time steps
+   */
+  void update(const double* times, const double* values, int size);
+
+  /**
+   * @brief Check if the parameter has the given time series
+   *
+   * @param times Time steps corresponding to the values
+   * @param values Values correspondong to the time steps
+   * @param size Number of time steps
+   * @return True if the times and values are equal to the given ones
+   */
+  bool has_time_series(const double* times, const double* values,
+                       int size) const;
+
   /**
    * @brief Get the parameter value at the specified time.
    *
@@ -118,6 +156,41 @@ class Parameter {
 
  private:
   bool steady_converted = false;
+  int cursor = 0;                  ///< Interval of the last evaluation
+  bool is_uniform = false;         ///< Whether the time steps are equidistant
+  double inverse_time_step = 0.0;  ///< Inverse of the equidistant time step
+
+  /**
+   * @brief Reset the interval search after the time series changed
+   *
+   */
+  void setup_interval_search();
+
+  std::vector<double> slopes;  ///< Derivatives at the time steps for cubic
+                               ///< Hermite interpolation
+
+  /**
+   * @brief Compute the derivatives at the time steps for cubic interpolation
+   *
+   * The cubic interpolants are only used for periodic time series with at
+   * least four time steps. The derivatives are cleared otherwise, which
+   * selects linear interpolation.
+   */
+  void setup_slopes();
+
+  /**
+   * @brief Find the first time step that is not smaller than the given time
+   *
+   * Equivalent to std::lower_bound, but starts from the interval of the
+   * previous call. For time advancing monotonically through the time series
+   * this only takes one or two comparisons. For other jumps in time the
+   * index is computed directly if the time steps are equidistant and found
+   * by binary search otherwise.
+   *
+   * @param time Time within the time series
+   * @return Index of the time step
+   */
+  int find_interval(double time);
 };
 
 #endif  // SVZERODSOLVER_MODEL_PARAMETER_HPP_
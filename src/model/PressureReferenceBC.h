@@ -79,7 +79,7 @@
  * * `0` Pressure
  *
  */
-class PressureReferenceBC : public Block {
+class PressureReferenceBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -113,6 +113,13 @@ class PressureReferenceBC : public Block {
    */
   void update_time(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
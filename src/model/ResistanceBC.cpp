@@ -34,6 +34,10 @@ void ResistanceBC::setup_dofs(DOFHandler &dofhandler) {
   Block::setup_dofs_(dofhandler, 1, {});
 }
 
+void ResistanceBC::setup_slots() {
+  register_slot(SystemMatrix::F, global_eqn_ids[0], global_var_ids[1]);
+}
+
 void ResistanceBC::update_constant(SparseSystem &system,
                                    std::vector<double> &parameters) {
   system.F.coeffRef(global_eqn_ids[0], global_var_ids[0]) = 1.0;
@@ -41,7 +45,8 @@ void ResistanceBC::update_constant(SparseSystem &system,
 
 void ResistanceBC::update_time(SparseSystem &system,
                                std::vector<double> &parameters) {
-  system.F.coeffRef(global_eqn_ids[0], global_var_ids[1]) =
-      -parameters[global_param_ids[0]];
+  system.slot(global_slot_ids[0]) = -parameters[global_param_ids[0]];
   system.C(global_eqn_ids[0]) = -parameters[global_param_ids[1]];
 }
+
+int ResistanceBC::get_dependencies() { return TIME_DEPENDENT; }
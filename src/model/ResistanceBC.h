@@ -77,7 +77,7 @@
  * * `1` Distal pressure
  *
  */
-class ResistanceBC : public Block {
+class ResistanceBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -94,6 +94,13 @@ class ResistanceBC : public Block {
    */
   void setup_dofs(DOFHandler &dofhandler);
 
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse system
    *
@@ -111,6 +118,13 @@ class ResistanceBC : public Block {
    */
   void update_time(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
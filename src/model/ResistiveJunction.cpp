@@ -67,3 +67,5 @@ void ResistiveJunction::update_constant(SparseSystem &system,
                       global_var_ids[i]) = -1.0;
   }
 }
+
+int ResistiveJunction::get_dependencies() { return CONSTANT; }
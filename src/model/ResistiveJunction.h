@@ -102,7 +102,7 @@
  * * `i` Poiseuille resistance for inner blood vessel `i`
  *
  */
-class ResistiveJunction : public Block {
+class ResistiveJunction final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -127,6 +127,13 @@ class ResistiveJunction : public Block {
    */
   void update_constant(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
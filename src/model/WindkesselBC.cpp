@@ -34,6 +34,12 @@ void WindkesselBC::setup_dofs(DOFHandler &dofhandler) {
   Block::setup_dofs_(dofhandler, 2, {"pressure_c"});
 }
 
+void WindkesselBC::setup_slots() {
+  register_slot(SystemMatrix::E, global_eqn_ids[1], global_var_ids[2]);
+  register_slot(SystemMatrix::F, global_eqn_ids[0], global_var_ids[1]);
+  register_slot(SystemMatrix::F, global_eqn_ids[1], global_var_ids[1]);
+}
+
 void WindkesselBC::update_constant(SparseSystem &system,
 
                                    std::vector<double> &parameters) {
@@ -45,11 +51,11 @@ void WindkesselBC::update_constant(SparseSystem &system,
 void WindkesselBC::update_time(SparseSystem &system,
 
                                std::vector<double> &parameters) {
-  system.E.coeffRef(global_eqn_ids[1], global_var_ids[2]) =
+  system.slot(global_slot_ids[0]) =
       -parameters[global_param_ids[2]] * parameters[global_param_ids[1]];
-  system.F.coeffRef(global_eqn_ids[0], global_var_ids[1]) =
-      -parameters[global_param_ids[0]];
-  system.F.coeffRef(global_eqn_ids[1], global_var_ids[1]) =
-      parameters[global_param_ids[2]];
+  system.slot(global_slot_ids[1]) = -parameters[global_param_ids[0]];
+  system.slot(global_slot_ids[2]) = parameters[global_param_ids[2]];
   system.C(global_eqn_ids[1]) = parameters[global_param_ids[3]];
 }
+
+int WindkesselBC::get_dependencies() { return TIME_DEPENDENT; }
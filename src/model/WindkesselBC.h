@@ -103,7 +103,7 @@
  * * `3` Distal pressure
  *
  */
-class WindkesselBC : public Block {
+class WindkesselBC final : public Block {
  public:
   // Inherit constructors
   using Block::Block;
@@ -120,6 +120,13 @@ class WindkesselBC : public Block {
    */
   void setup_dofs(DOFHandler &dofhandler);
 
+  /**
+   * @brief Register the time- and solution-dependent system matrix entries of
+   * the block
+   *
+   */
+  void setup_slots();
+
   /**
    * @brief Update the constant contributions of the element in a sparse
    system
@@ -138,6 +145,13 @@ class WindkesselBC : public Block {
    */
   void update_time(SparseSystem &system, std::vector<double> &parameters);
 
+  /**
+   * @brief Get the dependencies of the contributions of the block
+   *
+   * @return Dependencies of the block (combination of Block::Dependency)
+   */
+  int get_dependencies();
+
   /**
    * @brief Number of triplets of element
    *
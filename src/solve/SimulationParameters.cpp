@@ -84,6 +84,34 @@ SimulationParameters load_simulation_params(const nlohmann::json& config) {
   sim_params.sim_nliter = sim_config.value("maximum_nonlinear_iterations", 30);
   sim_params.sim_steady_initial = sim_config.value("steady_initial", true);
   sim_params.sim_rho_infty = sim_config.value("rho_infty", 0.5);
+  sim_params.sim_jacobian_reuse_threshold =
+      sim_config.value("jacobian_reuse_threshold", 0.0);
+  if ((sim_params.sim_jacobian_reuse_threshold < 0.0) ||
+      (sim_params.sim_jacobian_reuse_threshold >= 1.0)) {
+    throw std::runtime_error(
+        "Jacobian reuse threshold must be in the interval [0, 1).");
+  }
+  std::map<std::string, LinearSolverType> linear_solver_types = {
+      {"auto", LinearSolverType::automatic},
+      {"sparse_lu", LinearSolverType::sparse_lu},
+      {"dense_lu", LinearSolverType::dense_lu},
+      {"btf_lu", LinearSolverType::btf_lu}};
+  std::string linear_solver = sim_config.value("linear_solver", "auto");
+  if (linear_solver_types.count(linear_solver) == 0) {
+    throw std::runtime_error("Unknown linear solver: " + linear_solver);
+  }
+  sim_params.sim_linear_solver = linear_solver_types[linear_solver];
+  sim_params.sim_adaptive_time_stepping =
+      sim_config.value("adaptive_time_stepping", false);
+  sim_params.sim_adaptive_tolerance =
+      sim_config.value("adaptive_time_stepping_tolerance", 1e-4);
+  sim_params.sim_use_cycle_to_cycle_error =
+      sim_config.value("use_cycle_to_cycle_error", false);
+  sim_params.sim_cycle_to_cycle_tolerance =
+      sim_config.value("cycle_to_cycle_tolerance", 1e-4);
+  sim_params.sim_periodic_steady_state =
+      sim_config.value("periodic_steady_state", false);
+  sim_params.sim_anderson_depth = sim_config.value("anderson_depth", 5);
   sim_params.output_variable_based =
       sim_config.value("output_variable_based", false);
   sim_params.output_interval = sim_config.value("output_interval", 1);
@@ -102,6 +130,22 @@ SimulationParameters load_simulation_params(const nlohmann::json& config) {
 void load_simulation_model(const nlohmann::json& config, Model& model) {
   // DEBUG_MSG("Loading model");
 
+  // Interpolation of the periodic time-dependent parameters
+  std::map<std::string, InterpolationType> interpolation_types = {
+      {"linear", InterpolationType::linear},
+      {"spline", InterpolationType::periodic_spline},
+      {"pchip", InterpolationType::pchip}};
+  std::string interpolation = "linear";
+  if (config.contains("simulation_parameters")) {
+    interpolation = config["simulation_parameters"].value(
+        "parameter_interpolation", "linear");
+  }
+  if (interpolation_types.count(interpolation) == 0) {
+    throw std::runtime_error("Unknown parameter interpolation: " +
+                             interpolation);
+  }
+  model.parameter_interpolation = interpolation_types[interpolation];
+
   // Create list to store block connections while generating blocks
   std::vector<std::tuple<std::string, std::string>> connections;
 
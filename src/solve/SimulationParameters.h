@@ -36,6 +36,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "LinearSolver.h"
 #include "Model.h"
 #include "State.h"
 
@@ -68,6 +69,25 @@ struct SimulationParameters {
       false};  ///< Running 0D simulation coupled with external solver
   double sim_external_step_size{0.0};  ///< Step size of external solver if
                                        ///< running coupled
+
+  double sim_jacobian_reuse_threshold{
+      0.0};  ///< Maximum residual contraction for reusing outdated jacobians
+  LinearSolverType sim_linear_solver{
+      LinearSolverType::automatic};  ///< Type of the linear solver
+
+  bool sim_adaptive_time_stepping{false};  ///< Use adaptive time step size
+  double sim_adaptive_tolerance{
+      0.0};  ///< Relative tolerance for the local error of adaptive time steps
+
+  bool sim_use_cycle_to_cycle_error{
+      false};  ///< Stop once the solution is periodic
+  double sim_cycle_to_cycle_tolerance{
+      0.0};  ///< Relative tolerance for the change of the state between
+             ///< cardiac cycles
+  bool sim_periodic_steady_state{
+      false};  ///< Solve for the periodic state before the last cycle
+  size_t sim_anderson_depth{0};  ///< Number of previous cycles used in the
+                                 ///< Anderson acceleration
 };
 
 State load_initial_condition(const nlohmann::json& config, Model& model);
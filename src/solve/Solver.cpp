@@ -1,7 +1,49 @@
 #include "Solver.h"
 
+#include <algorithm>
+#include <deque>
+
 #include "csv_writer.h"
 
+/**
+ * @brief Interpolate the solution between two time steps
+ *
+ * Uses linear interpolation. Other than Hermite interpolation, this does not
+ * rely on the time derivative of algebraic quantities, which is not accurate
+ * in the generalized-alpha method.
+ *
+ * @param state_0 State at time_0
+ * @param state_1 State at time_1
+ * @param time_0 Time of state_0
+ * @param time_1 Time of state_1
+ * @param time Time to interpolate the state at
+ * @return Interpolated state
+ */
+State interpolate_state(const State& state_0, const State& state_1,
+                        double time_0, double time_1, double time) {
+  double t = std::clamp((time - time_0) / (time_1 - time_0), 0.0, 1.0);
+  State state(state_0.y.size());
+  state.y = (1.0 - t) * state_0.y + t * state_1.y;
+  state.ydot = (1.0 - t) * state_0.ydot + t * state_1.ydot;
+  return state;
+}
+
+/**
+ * @brief Check if the state is periodic
+ *
+ * @param state_0 State at the start of a cardiac cycle
+ * @param state_1 State at the end of the cardiac cycle
+ * @param tolerance Relative tolerance for the change of the state
+ * @return Whether the change of the state in the cycle is within the tolerance
+ */
+bool is_periodic_state(const State& state_0, const State& state_1,
+                       double tolerance) {
+  return ((state_1.y - state_0.y).lpNorm<Eigen::Infinity>() <=
+          tolerance * state_1.y.lpNorm<Eigen::Infinity>()) &&
+         ((state_1.ydot - state_0.ydot).lpNorm<Eigen::Infinity>() <=
+          tolerance * state_1.ydot.lpNorm<Eigen::Infinity>());
+}
+
 Solver::Solver(const nlohmann::json& config) {
   DEBUG_MSG("Read simulation parameters");
   simparams = load_simulation_params(config);
@@ -35,12 +77,18 @@ void Solver::run() {
     double time_step_size_steady = model.cardiac_cycle_period / 10.0;
     model.to_steady();
 
-    Integrator integrator_steady(&model, time_step_size_steady,
-                                 simparams.sim_rho_infty, simparams.sim_abs_tol,
-                                 simparams.sim_nliter);
-
-    for (int i = 0; i < 31; i++) {
-      state = integrator_steady.step(state, time_step_size_steady * double(i));
+    Integrator integrator_steady(
+        &model, time_step_size_steady, simparams.sim_rho_infty,
+        simparams.sim_abs_tol, simparams.sim_nliter,
+        simparams.sim_jacobian_reuse_threshold, simparams.sim_linear_solver);
+
+    // Use pseudo-time steps if the Newton-Raphson iterations fail
+    if (!integrator_steady.solve_steady_state(state, 0.0)) {
+      DEBUG_MSG("Use pseudo-time steps for steady initial condition");
+      for (int i = 0; i < 31; i++) {
+        integrator_steady.step_in_place(state,
+                                        time_step_size_steady * double(i));
+      }
     }
 
     model.to_unsteady();
@@ -50,15 +98,42 @@ void Solver::run() {
   DEBUG_MSG("Setup time integration");
   Integrator integrator(&model, simparams.sim_time_step_size,
                         simparams.sim_rho_infty, simparams.sim_abs_tol,
-                        simparams.sim_nliter);
+                        simparams.sim_nliter,
+                        simparams.sim_jacobian_reuse_threshold,
+                        simparams.sim_linear_solver);
+
+  // Adaptive time steps are at least a hundredth of the output time step and
+  // at most a twentieth of a cardiac cycle (but not smaller than the output
+  // time step)
+  if (simparams.sim_adaptive_time_stepping) {
+    integrator.setup_adaptive_time_stepping(
+        simparams.sim_adaptive_tolerance, simparams.sim_time_step_size * 1e-2,
+        std::max(simparams.sim_time_step_size,
+                 model.cardiac_cycle_period / 20.0));
+  }
+
+  // Solve for the periodic state at the start of a cardiac cycle and only
+  // simulate the last cycle
+  int num_time_steps = simparams.sim_num_time_steps;
+  num_cycles = 0;
+  if (simparams.sim_periodic_steady_state) {
+    DEBUG_MSG("Calculate periodic steady state");
+    state = solve_periodic_state(integrator, state);
+    num_time_steps = simparams.sim_pts_per_cycle;
+  }
+
+  double end_time = simparams.sim_time_step_size * double(num_time_steps - 1);
+  double adaptive_time = 0.0;
+  double adaptive_time_prev = 0.0;
+  State adaptive_state = state;
+  State adaptive_state_prev = state;
 
   // Initialize loop
   states = std::vector<State>();
   times = std::vector<double>();
 
   if (simparams.output_all_cycles) {
-    int num_states =
-        simparams.sim_num_time_steps / simparams.output_interval + 1;
+    int num_states = num_time_steps / simparams.output_interval + 1;
     states.reserve(num_states);
     times.reserve(num_states);
 
@@ -73,19 +148,61 @@ void Solver::run() {
   // Run integrator
   DEBUG_MSG("Run time integration");
   int interval_counter = 0;
-  int start_last_cycle =
-      simparams.sim_num_time_steps - simparams.sim_pts_per_cycle;
+  int start_last_cycle = num_time_steps - simparams.sim_pts_per_cycle;
+  int num_steps_per_cycle = simparams.sim_pts_per_cycle - 1;
+
+  // If the simulation stops once the solution is periodic, every cycle may be
+  // the last one
+  State cycle_start_state;
+  if (simparams.sim_use_cycle_to_cycle_error) {
+    start_last_cycle = 0;
+    cycle_start_state = state;
+  }
 
   if (simparams.output_all_cycles || (0 >= start_last_cycle)) {
     times.push_back(time);
     states.push_back(std::move(state));
   }
 
-  for (int i = 1; i < simparams.sim_num_time_steps; i++) {
-    state = integrator.step(state, time);
+  for (int i = 1; i < num_time_steps; i++) {
+    if (simparams.sim_adaptive_time_stepping) {
+      // Integrate with adaptive time steps beyond the output time and
+      // interpolate
+      double output_time = simparams.sim_time_step_size * double(i);
+      while (adaptive_time <
+             output_time - 1e-10 * simparams.sim_time_step_size) {
+        adaptive_time_prev = adaptive_time;
+        adaptive_state_prev = std::move(adaptive_state);
+        adaptive_state = integrator.step_adaptive(adaptive_state_prev,
+                                                  adaptive_time, end_time);
+      }
+      state = interpolate_state(adaptive_state_prev, adaptive_state,
+                                adaptive_time_prev, adaptive_time, output_time);
+    } else {
+      integrator.step_in_place(state, time);
+    }
     interval_counter += 1;
     time = simparams.sim_time_step_size * double(i);
 
+    // Compare the states at the start and end of each cardiac cycle
+    bool is_periodic = false;
+    if (i % num_steps_per_cycle == 0) {
+      num_cycles++;
+      if (simparams.sim_use_cycle_to_cycle_error) {
+        is_periodic = is_periodic_state(cycle_start_state, state,
+                                        simparams.sim_cycle_to_cycle_tolerance);
+        cycle_start_state = state;
+
+        // Discard the output of the previous cycle
+        if (!is_periodic && !simparams.output_all_cycles &&
+            (i < num_time_steps - 1)) {
+          start_last_cycle = i;
+          times.clear();
+          states.clear();
+        }
+      }
+    }
+
     if ((interval_counter == simparams.output_interval) ||
         (!simparams.output_all_cycles && (i == start_last_cycle))) {
       if (simparams.output_all_cycles || (i >= start_last_cycle)) {
@@ -94,10 +211,23 @@ void Solver::run() {
       }
       interval_counter = 0;
     }
+
+    if (is_periodic) {
+      break;
+    }
   }
 
+  DEBUG_MSG("Number of simulated cardiac cycles: " << num_cycles);
+
   DEBUG_MSG("Avg. number of nonlinear iterations per time step: "
             << integrator.avg_nonlin_iter());
+  DEBUG_MSG("Number of saved factorizations of the jacobian: "
+            << integrator.num_saved_factorizations());
+  if (simparams.sim_adaptive_time_stepping) {
+    DEBUG_MSG("Number of accepted/rejected adaptive time steps: "
+              << integrator.num_accepted_steps() << "/"
+              << integrator.num_rejected_steps());
+  }
 
   // Make times start from 0
   if (!simparams.output_all_cycles) {
@@ -108,8 +238,72 @@ void Solver::run() {
   }
 }
 
+State Solver::solve_periodic_state(Integrator& integrator,
+                                   const State& state) {
+  int n = state.y.size();
+  int num_steps_per_cycle = simparams.sim_pts_per_cycle - 1;
+
+  // Stacked solution and time derivative at the start (x) and end (g) of a
+  // cycle and history of their changes for the Anderson acceleration
+  Eigen::VectorXd x(2 * n), g(2 * n), f(2 * n), g_prev, f_prev;
+  x << state.y, state.ydot;
+  std::deque<Eigen::VectorXd> delta_g, delta_f;
+
+  State cycle_start_state(n);
+  State cycle_end_state = state;
+  for (int k = 0; k < simparams.sim_num_cycles; k++) {
+    // Integrate over one cardiac cycle
+    cycle_start_state.y = x.head(n);
+    cycle_start_state.ydot = x.tail(n);
+    cycle_end_state = cycle_start_state;
+    for (int i = 0; i < num_steps_per_cycle; i++) {
+      integrator.step_in_place(cycle_end_state,
+                               simparams.sim_time_step_size * double(i));
+    }
+    num_cycles++;
+
+    if (is_periodic_state(cycle_start_state, cycle_end_state,
+                          simparams.sim_cycle_to_cycle_tolerance)) {
+      break;
+    }
+
+    // Anderson acceleration of the fixed-point iteration x = g(x)
+    g << cycle_end_state.y, cycle_end_state.ydot;
+    f = g - x;
+    if (k > 0) {
+      delta_g.push_back(g - g_prev);
+      delta_f.push_back(f - f_prev);
+      if (delta_g.size() > simparams.sim_anderson_depth) {
+        delta_g.pop_front();
+        delta_f.pop_front();
+      }
+    }
+    g_prev = g;
+    f_prev = f;
+
+    x = g;
+    if (!delta_f.empty()) {
+      Eigen::MatrixXd delta_f_matrix(2 * n, delta_f.size());
+      for (size_t j = 0; j < delta_f.size(); j++) {
+        delta_f_matrix.col(j) = delta_f[j];
+      }
+      Eigen::VectorXd coefficients =
+          delta_f_matrix.colPivHouseholderQr().solve(f);
+      for (size_t j = 0; j < delta_g.size(); j++) {
+        x -= coefficients[j] * delta_g[j];
+      }
+    }
+  }
+  DEBUG_MSG("Number of cardiac cycles for periodic steady state: "
+            << num_cycles);
+
+  return cycle_end_state;
+}
+
 std::vector<double> Solver::get_times() const { return times; }
 
+int Solver::get_num_cycles() const { return num_cycles; }
+
 std::string Solver::get_full_result() const {
   std::string output;
 
@@ -94,6 +94,16 @@ class Solver {
    */
   std::vector<double> get_times() const;
 
+  /**
+   * @brief Get the number of simulated cardiac cycles
+   *
+   * This is smaller than the number of cardiac cycles in the configuration if
+   * the simulation stopped early with a periodic solution.
+   *
+   * @return int Number of simulated cardiac cycles
+   */
+  int get_num_cycles() const;
+
   /**
    * @brief Update the parameters of a block
    *
@@ -116,8 +126,25 @@ class Solver {
   std::vector<State> states;
   std::vector<double> times;
   State initial_state;
+  int num_cycles{0};
 
   void sanity_checks();
+
+  /**
+   * @brief Compute the periodic state at the start of a cardiac cycle
+   *
+   * Solves \f$\mathbf{x} = \mathbf{g}(\mathbf{x})\f$, where
+   * \f$\mathbf{g}\f$ maps the state at the start of a cardiac cycle to the
+   * state at its end, with Anderson acceleration of the fixed-point
+   * iteration. Each iteration integrates one cardiac cycle. The iteration
+   * stops once the state is periodic within the cycle-to-cycle tolerance or
+   * after the configured number of cardiac cycles.
+   *
+   * @param integrator Time integrator
+   * @param state Initial guess for the periodic state
+   * @return State at the end of the last integrated cycle
+   */
+  State solve_periodic_state(Integrator& integrator, const State& state);
 };
 
 #endif
@@ -20,6 +20,18 @@ LPNSolverInterface::LPNSolverInterface()
   lpn_return_ydot_name_ = "return_ydot";
   lpn_return_y_name_ = "return_y";
   lpn_set_external_step_size_name_ = "set_external_step_size";
+  lpn_get_state_data_name_ = "get_state_data";
+  lpn_return_state_data_name_ = "return_state_data";
+  lpn_update_state_data_name_ = "update_state_data";
+  lpn_increment_time_data_name_ = "increment_time_data";
+  lpn_increment_time_batch_name_ = "increment_time_batch";
+  lpn_finalize_name_ = "finalize";
+  lpn_increment_time_trial_name_ = "increment_time_trial";
+  lpn_get_trial_state_data_name_ = "get_trial_state_data";
+  lpn_commit_time_step_name_ = "commit_time_step";
+  lpn_checkpoint_name_ = "checkpoint";
+  lpn_rollback_name_ = "rollback";
+  lpn_get_block_tangent_name_ = "get_block_tangent";
 }
 
 LPNSolverInterface::~LPNSolverInterface()
@@ -120,6 +132,102 @@ void LPNSolverInterface::load_library(const std::string& interface_lib)
     dlclose(library_handle_);
     return;
   }
+
+  // Get a pointer to the svzero 'get_state_data' function.
+  *(void**)(&lpn_get_state_data_) = dlsym(library_handle_, "get_state_data");
+  if (!lpn_get_state_data_) {
+    std::cerr << "Error loading function 'lpn_get_state_data' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'return_state_data' function.
+  *(void**)(&lpn_return_state_data_) = dlsym(library_handle_, "return_state_data");
+  if (!lpn_return_state_data_) {
+    std::cerr << "Error loading function 'lpn_return_state_data' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'update_state_data' function.
+  *(void**)(&lpn_update_state_data_) = dlsym(library_handle_, "update_state_data");
+  if (!lpn_update_state_data_) {
+    std::cerr << "Error loading function 'lpn_update_state_data' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'increment_time_data' function.
+  *(void**)(&lpn_increment_time_data_) = dlsym(library_handle_, "increment_time_data");
+  if (!lpn_increment_time_data_) {
+    std::cerr << "Error loading function 'lpn_increment_time_data' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'increment_time_batch' function.
+  *(void**)(&lpn_increment_time_batch_) = dlsym(library_handle_, "increment_time_batch");
+  if (!lpn_increment_time_batch_) {
+    std::cerr << "Error loading function 'lpn_increment_time_batch' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'finalize' function.
+  *(void**)(&lpn_finalize_) = dlsym(library_handle_, "finalize");
+  if (!lpn_finalize_) {
+    std::cerr << "Error loading function 'lpn_finalize' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'increment_time_trial' function.
+  *(void**)(&lpn_increment_time_trial_) = dlsym(library_handle_, "increment_time_trial");
+  if (!lpn_increment_time_trial_) {
+    std::cerr << "Error loading function 'lpn_increment_time_trial' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'get_trial_state_data' function.
+  *(void**)(&lpn_get_trial_state_data_) = dlsym(library_handle_, "get_trial_state_data");
+  if (!lpn_get_trial_state_data_) {
+    std::cerr << "Error loading function 'lpn_get_trial_state_data' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'commit_time_step' function.
+  *(void**)(&lpn_commit_time_step_) = dlsym(library_handle_, "commit_time_step");
+  if (!lpn_commit_time_step_) {
+    std::cerr << "Error loading function 'lpn_commit_time_step' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'checkpoint' function.
+  *(void**)(&lpn_checkpoint_) = dlsym(library_handle_, "checkpoint");
+  if (!lpn_checkpoint_) {
+    std::cerr << "Error loading function 'lpn_checkpoint' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'rollback' function.
+  *(void**)(&lpn_rollback_) = dlsym(library_handle_, "rollback");
+  if (!lpn_rollback_) {
+    std::cerr << "Error loading function 'lpn_rollback' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
+
+  // Get a pointer to the svzero 'get_block_tangent' function.
+  *(void**)(&lpn_get_block_tangent_) = dlsym(library_handle_, "get_block_tangent");
+  if (!lpn_get_block_tangent_) {
+    std::cerr << "Error loading function 'lpn_get_block_tangent' with error: " << dlerror() << std::endl;
+    dlclose(library_handle_);
+    return;
+  }
 }
 
 // Initialze the LPN solver.
@@ -249,3 +357,143 @@ void LPNSolverInterface::return_ydot(std::vector<double>& ydot)
 {
   lpn_return_ydot_(problem_id_, ydot);
 }
+
+// Get pointers to the 0D state vectors (valid for the lifetime of the 0D
+// problem)
+//
+// Parameters:
+//
+//   y: The y state vector
+//
+//   ydot: The ydot state vector
+//
+int LPNSolverInterface::get_state_data(double*& y, double*& ydot)
+{
+  int system_size = 0;
+  return lpn_get_state_data_(problem_id_, &y, &ydot, &system_size);
+}
+
+// Return the 0D state vectors in arrays of length system_size_
+//
+// Parameters:
+//
+//   y: The y state vector
+//
+//   ydot: The ydot state vector
+//
+int LPNSolverInterface::return_state_data(double* y, double* ydot)
+{
+  return lpn_return_state_data_(problem_id_, y, ydot, system_size_);
+}
+
+// Overwrite the 0D state vectors from arrays of length system_size_
+//
+// Parameters:
+//
+//   y: The y state vector
+//
+//   ydot: The ydot state vector
+//
+int LPNSolverInterface::update_state_data(const double* y, const double* ydot)
+{
+  return lpn_update_state_data_(problem_id_, y, ydot, system_size_);
+}
+
+// Increment the LPN solution in time.
+//
+// Parameters:
+//
+//   time: The solution time.
+//
+//   solution: The returned LPN solution (array of length system_size_ or
+//             nullptr).
+//
+int LPNSolverInterface::increment_time_data(const double time, double* solution)
+{
+  return lpn_increment_time_data_(problem_id_, time, solution, system_size_);
+}
+
+// Increment the LPN solutions of multiple problems in time (in parallel).
+//
+// Parameters:
+//
+//   problem_ids: The IDs of the LPN problems.
+//
+//   time: The solution time.
+//
+//   num_threads: The number of threads (0 for all available cores).
+//
+//   error_codes: The returned error code of each problem.
+//
+int LPNSolverInterface::increment_time_batch(const std::vector<int>& problem_ids, const double time, int num_threads, std::vector<int>& error_codes)
+{
+  error_codes.resize(problem_ids.size());
+  return lpn_increment_time_batch_(problem_ids.data(), problem_ids.size(), time, num_threads, error_codes.data());
+}
+
+// Delete the LPN problem and release its memory.
+//
+int LPNSolverInterface::finalize()
+{
+  return lpn_finalize_(problem_id_);
+}
+
+// Compute a trial time step that does not change the LPN state.
+//
+// Parameters:
+//
+//   time: The solution time.
+//
+int LPNSolverInterface::increment_time_trial(const double time)
+{
+  return lpn_increment_time_trial_(problem_id_, time);
+}
+
+// Get pointers to the state vectors of the last trial time step
+//
+// Parameters:
+//
+//   y: The y state vector
+//
+//   ydot: The ydot state vector
+//
+int LPNSolverInterface::get_trial_state_data(double*& y, double*& ydot)
+{
+  int system_size = 0;
+  return lpn_get_trial_state_data_(problem_id_, &y, &ydot, &system_size);
+}
+
+// Apply the last trial time step to the LPN state.
+//
+int LPNSolverInterface::commit_time_step()
+{
+  return lpn_commit_time_step_(problem_id_);
+}
+
+// Save the LPN state and parameters.
+//
+int LPNSolverInterface::checkpoint()
+{
+  return lpn_checkpoint_(problem_id_);
+}
+
+// Restore the LPN state and parameters of the last checkpoint.
+//
+int LPNSolverInterface::rollback()
+{
+  return lpn_rollback_(problem_id_);
+}
+
+// Get the sensitivity of the last time step to the boundary value of a block.
+//
+// Parameters:
+//
+//   block_name: The name of the FLOW or PRESSURE block.
+//
+//   tangent: The derivatives of all degrees-of-freedom.
+//
+int LPNSolverInterface::get_block_tangent(std::string block_name, std::vector<double>& tangent)
+{
+  tangent.resize(system_size_);
+  return lpn_get_block_tangent_(problem_id_, block_name.c_str(), tangent.data(), system_size_);
+}
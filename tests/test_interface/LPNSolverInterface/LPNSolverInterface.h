@@ -30,6 +30,18 @@ class LPNSolverInterface
     void return_y(std::vector<double>& y);
     void return_ydot(std::vector<double>& ydot);
     void set_external_step_size(double step_size);
+    int get_state_data(double*& y, double*& ydot);
+    int return_state_data(double* y, double* ydot);
+    int update_state_data(const double* y, const double* ydot);
+    int increment_time_data(const double time, double* solution);
+    int increment_time_batch(const std::vector<int>& problem_ids, const double time, int num_threads, std::vector<int>& error_codes);
+    int finalize();
+    int increment_time_trial(const double time);
+    int get_trial_state_data(double*& y, double*& ydot);
+    int commit_time_step();
+    int checkpoint();
+    int rollback();
+    int get_block_tangent(std::string block_name, std::vector<double>& tangent);
 
     // Interface functions.
     std::string lpn_initialize_name_;
@@ -62,6 +74,42 @@ class LPNSolverInterface
     std::string lpn_set_external_step_size_name_;
     void (*lpn_set_external_step_size_)(const int, double);
 
+    std::string lpn_get_state_data_name_;
+    int (*lpn_get_state_data_)(const int, double**, double**, int*);
+
+    std::string lpn_return_state_data_name_;
+    int (*lpn_return_state_data_)(const int, double*, double*, int);
+
+    std::string lpn_update_state_data_name_;
+    int (*lpn_update_state_data_)(const int, const double*, const double*, int);
+
+    std::string lpn_increment_time_data_name_;
+    int (*lpn_increment_time_data_)(const int, const double, double*, int);
+
+    std::string lpn_increment_time_batch_name_;
+    int (*lpn_increment_time_batch_)(const int*, int, const double, int, int*);
+
+    std::string lpn_finalize_name_;
+    int (*lpn_finalize_)(const int);
+
+    std::string lpn_increment_time_trial_name_;
+    int (*lpn_increment_time_trial_)(const int, const double);
+
+    std::string lpn_get_trial_state_data_name_;
+    int (*lpn_get_trial_state_data_)(const int, double**, double**, int*);
+
+    std::string lpn_commit_time_step_name_;
+    int (*lpn_commit_time_step_)(const int);
+
+    std::string lpn_checkpoint_name_;
+    int (*lpn_checkpoint_)(const int);
+
+    std::string lpn_rollback_name_;
+    int (*lpn_rollback_)(const int);
+
+    std::string lpn_get_block_tangent_name_;
+    int (*lpn_get_block_tangent_)(const int, const char*, double*, int);
+
     void* library_handle_ = nullptr;
     int problem_id_ = 0;
     int system_size_ = 0;
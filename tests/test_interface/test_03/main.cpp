@@ -0,0 +1,110 @@
+// Test that time stepping through the svZeroDPlus interface does not allocate
+// memory in every time step.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <fstream>
+#include <string>
+
+//-----------------------------------------------------------
+// Count calls to malloc (also used by operator new and Eigen)
+//-----------------------------------------------------------
+#if defined(__GLIBC__)
+static bool count_allocations = false;
+static long num_allocations = 0;
+
+extern "C" void* __libc_malloc(size_t size);
+
+extern "C" void* malloc(size_t size) {
+  if (count_allocations) {
+    num_allocations++;
+  }
+  return __libc_malloc(size);
+}
+#endif
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  LPNSolverInterface interface;
+
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test03 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // Load shared library and get interface functions.
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  if (lib_so_exists) {
+    interface.load_library(interface_lib_so);
+  } else if (lib_dylib_exists) {
+    interface.load_library(interface_lib_dylib);
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+
+  // Set up the svZeroD model
+  std::string file_name = std::string(argv[2]);
+  interface.initialize(file_name);
+  interface.set_external_step_size(0.01);
+
+  // Set up vectors to run svZeroD simulation
+  std::vector<double> solutions(interface.system_size_*interface.num_output_steps_);
+  std::vector<double> times(interface.num_output_steps_);
+  int error_code = 0;
+
+  // The first simulation factorizes the jacobian of the (linear) model
+  interface.run_simulation(0.0, times, solutions, error_code);
+  if (error_code != 0) {
+    throw std::runtime_error("Error in first simulation");
+  }
+
+#if defined(__GLIBC__)
+  // Count allocations in subsequent simulations
+  long num_allocations_run[2];
+  for (int i = 0; i < 2; i++) {
+    num_allocations = 0;
+    count_allocations = true;
+    interface.run_simulation(0.01 * double(i + 1), times, solutions, error_code);
+    count_allocations = false;
+    num_allocations_run[i] = num_allocations;
+    if (error_code != 0) {
+      throw std::runtime_error("Error in simulation " + std::to_string(i + 2));
+    }
+  }
+  std::cout << "Allocations per simulation: " << num_allocations_run[0] << std::endl;
+
+  // Allocations for the setup of a simulation are fine, allocations in every
+  // time step are not
+  if (num_allocations_run[0] != num_allocations_run[1]) {
+    throw std::runtime_error("Number of allocations differs between simulations");
+  }
+  if (num_allocations_run[0] >= interface.num_output_steps_) {
+    throw std::runtime_error("Memory is allocated in time steps");
+  }
+#else
+  std::cout << "Allocations are only counted with glibc" << std::endl;
+#endif
+
+  // Inflow is constant
+  std::vector<int> IDs;
+  interface.get_block_node_IDs("inlet_vessel", IDs);
+  int inflow_id = IDs[2];
+  for (int t = 0; t < interface.num_output_steps_; t++) {
+    if (std::abs(solutions[interface.system_size_*t + inflow_id] - 1.0) > 1e-8) {
+      throw std::runtime_error("Wrong inflow at output step " + std::to_string(t));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+// Test the interface functions that exchange the state through raw pointers
+// against the functions that use std::vector.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  LPNSolverInterface interface_vector;
+  LPNSolverInterface interface_data;
+
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test04 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // Load shared library and get interface functions.
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+  interface_vector.load_library(interface_lib);
+  interface_data.load_library(interface_lib);
+
+  // Set up the same svZeroD model twice
+  std::string file_name = std::string(argv[2]);
+  interface_vector.initialize(file_name);
+  interface_data.initialize(file_name);
+  interface_vector.set_external_step_size(0.01);
+  interface_data.set_external_step_size(0.01);
+  int system_size = interface_vector.system_size_;
+
+  // Pointers to the state of the second model
+  double* y = nullptr;
+  double* ydot = nullptr;
+  if (interface_data.get_state_data(y, ydot) != 0) {
+    throw std::runtime_error("Could not get state data");
+  }
+
+  std::vector<double> solution_vector(system_size);
+  std::vector<double> solution_data(system_size);
+  std::vector<double> y_vector(system_size);
+  std::vector<double> ydot_vector(system_size);
+  std::vector<double> y_data(system_size);
+  std::vector<double> ydot_data(system_size);
+  double time = 0.0;
+  for (int step = 0; step < 50; step++) {
+    // Modify the state in the middle of the simulation
+    if (step == 25) {
+      interface_vector.return_y(y_vector);
+      interface_vector.return_ydot(ydot_vector);
+      for (int i = 0; i < system_size; i++) {
+        y_vector[i] *= 1.1;
+        y[i] *= 1.1;
+      }
+      interface_vector.update_state(y_vector, ydot_vector);
+    }
+
+    interface_vector.increment_time(time, solution_vector);
+    if (interface_data.increment_time_data(time, solution_data.data()) != 0) {
+      throw std::runtime_error("Error in time step " + std::to_string(step));
+    }
+    time += 0.01;
+
+    // Both interfaces return the same solution and state
+    interface_vector.return_y(y_vector);
+    interface_vector.return_ydot(ydot_vector);
+    if (interface_data.return_state_data(y_data.data(), ydot_data.data()) != 0) {
+      throw std::runtime_error("Could not return state data");
+    }
+    for (int i = 0; i < system_size; i++) {
+      if ((solution_vector[i] != solution_data[i]) ||
+          (y_vector[i] != y[i]) || (ydot_vector[i] != ydot[i]) ||
+          (y_data[i] != y[i]) || (ydot_data[i] != ydot[i])) {
+        throw std::runtime_error("Different state in time step " + std::to_string(step));
+      }
+    }
+  }
+
+  // The pointers to the state stay valid
+  double* y_new = nullptr;
+  double* ydot_new = nullptr;
+  interface_data.get_state_data(y_new, ydot_new);
+  if ((y_new != y) || (ydot_new != ydot)) {
+    throw std::runtime_error("Pointers to the state changed");
+  }
+
+  // Setting the state from arrays
+  interface_data.update_state_data(y_vector.data(), ydot_vector.data());
+  interface_vector.increment_time(time, solution_vector);
+  interface_data.increment_time_data(time, nullptr);
+  interface_vector.return_y(y_vector);
+  for (int i = 0; i < system_size; i++) {
+    if (y_vector[i] != y[i]) {
+      throw std::runtime_error("Different state after update_state_data");
+    }
+  }
+
+  // Errors are reported by the return value
+  if (interface_data.lpn_increment_time_data_(-1, time, nullptr, 0) != 1) {
+    throw std::runtime_error("Unknown problem ID was not detected");
+  }
+  if (interface_data.lpn_return_state_data_(interface_data.problem_id_, y_data.data(), ydot_data.data(), system_size - 1) != 1) {
+    throw std::runtime_error("Wrong vector size was not detected");
+  }
+
+  return 0;
+}
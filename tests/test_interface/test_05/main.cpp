@@ -0,0 +1,109 @@
+// Test that stepping multiple problems in parallel with increment_time_batch
+// gives the same results as stepping them one after the other.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <string>
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test05 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+
+  // Set up pairs of the same svZeroD model with different inflows. The first
+  // model of each pair is stepped in a batch, the second one separately.
+  const int num_problems = 8;
+  std::vector<std::unique_ptr<LPNSolverInterface>> interfaces;
+  std::vector<int> batch_ids;
+  std::string file_name = std::string(argv[2]);
+  for (int i = 0; i < 2 * num_problems; i++) {
+    interfaces.emplace_back(new LPNSolverInterface());
+    auto& interface = *interfaces.back();
+    interface.load_library(interface_lib);
+    interface.initialize(file_name);
+    interface.set_external_step_size(0.01);
+    double inflow = 1.0 + double(i / 2);
+    std::vector<double> params = {2.0, 0.0, 1.0, inflow, inflow};
+    interface.update_block_params("inlet_vessel", params);
+    if ((i % 2) == 0) {
+      batch_ids.push_back(interface.problem_id_);
+    }
+  }
+  int system_size = interfaces[0]->system_size_;
+
+  std::vector<int> error_codes;
+  double time = 0.0;
+  for (int step = 0; step < 100; step++) {
+    if (interfaces[0]->increment_time_batch(batch_ids, time, 4, error_codes) != 0) {
+      throw std::runtime_error("Error in batch time step " + std::to_string(step));
+    }
+    for (int i = 0; i < num_problems; i++) {
+      if (error_codes[i] != 0) {
+        throw std::runtime_error("Error in time step of problem " + std::to_string(i));
+      }
+      if (interfaces[2 * i + 1]->increment_time_data(time, nullptr) != 0) {
+        throw std::runtime_error("Error in time step " + std::to_string(step));
+      }
+    }
+    time += 0.01;
+
+    // Compare states of both models of each pair
+    for (int i = 0; i < num_problems; i++) {
+      double *y_batch, *ydot_batch, *y, *ydot;
+      interfaces[2 * i]->get_state_data(y_batch, ydot_batch);
+      interfaces[2 * i + 1]->get_state_data(y, ydot);
+      for (int j = 0; j < system_size; j++) {
+        if ((y_batch[j] != y[j]) || (ydot_batch[j] != ydot[j])) {
+          throw std::runtime_error("Different state of problem " + std::to_string(i) + " in time step " + std::to_string(step));
+        }
+      }
+    }
+  }
+
+  // The models have different inflows
+  std::vector<int> IDs;
+  interfaces[0]->get_block_node_IDs("inlet_vessel", IDs);
+  int inflow_id = IDs[2];
+  for (int i = 0; i < num_problems; i++) {
+    double *y, *ydot;
+    interfaces[2 * i]->get_state_data(y, ydot);
+    if (std::abs(y[inflow_id] - (1.0 + double(i))) > 1e-8) {
+      throw std::runtime_error("Wrong inflow of problem " + std::to_string(i));
+    }
+  }
+
+  // Errors of single problems are reported
+  std::vector<int> wrong_ids = {batch_ids[0], -1};
+  if (interfaces[0]->increment_time_batch(wrong_ids, time, 2, error_codes) != 1) {
+    throw std::runtime_error("Unknown problem ID was not detected");
+  }
+  if ((error_codes[0] != 0) || (error_codes[1] != 1)) {
+    throw std::runtime_error("Wrong error codes");
+  }
+
+  return 0;
+}
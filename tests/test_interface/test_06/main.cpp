@@ -0,0 +1,106 @@
+// Test creating, using and deleting svZeroD problems from multiple threads.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test06 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+  std::string file_name = std::string(argv[2]);
+
+  // Reference solution of a single problem
+  LPNSolverInterface reference;
+  reference.load_library(interface_lib);
+  reference.initialize(file_name);
+  reference.set_external_step_size(0.01);
+  for (int step = 0; step < 20; step++) {
+    reference.increment_time_data(0.01 * double(step), nullptr);
+  }
+  double *y_reference, *ydot_reference;
+  reference.get_state_data(y_reference, ydot_reference);
+
+  // Each thread repeatedly creates, steps and deletes problems
+  const int num_threads = 8;
+  const int num_problems_per_thread = 4;
+  std::vector<int> problem_ids(num_threads * num_problems_per_thread);
+  std::atomic<int> num_errors{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < num_problems_per_thread; i++) {
+        LPNSolverInterface interface;
+        interface.load_library(interface_lib);
+        interface.initialize(file_name);
+        interface.set_external_step_size(0.01);
+        problem_ids[t * num_problems_per_thread + i] = interface.problem_id_;
+        for (int step = 0; step < 20; step++) {
+          num_errors += interface.increment_time_data(0.01 * double(step), nullptr);
+        }
+        double *y, *ydot;
+        interface.get_state_data(y, ydot);
+        for (int j = 0; j < reference.system_size_; j++) {
+          if ((y[j] != y_reference[j]) || (ydot[j] != ydot_reference[j])) {
+            num_errors++;
+          }
+        }
+        num_errors += interface.finalize();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (num_errors != 0) {
+    throw std::runtime_error("Errors in threads");
+  }
+
+  // All problems had different IDs
+  std::set<int> unique_ids(problem_ids.begin(), problem_ids.end());
+  if (unique_ids.size() != problem_ids.size()) {
+    throw std::runtime_error("Problem IDs are not unique");
+  }
+
+  // Deleted problems cannot be used
+  double *y, *ydot;
+  if (reference.lpn_get_state_data_(problem_ids[0], &y, &ydot, nullptr) != 1) {
+    throw std::runtime_error("Deleted problem was found");
+  }
+  if (reference.lpn_finalize_(problem_ids[0]) != 1) {
+    throw std::runtime_error("Deleted problem was deleted again");
+  }
+
+  // Delete the reference problem
+  if (reference.finalize() != 0) {
+    throw std::runtime_error("Could not delete problem");
+  }
+
+  return 0;
+}
@@ -0,0 +1,120 @@
+// Test trial time steps and checkpoints for strongly coupled simulations.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <iostream>
+#include <fstream>
+#include <string>
+
+// Set the inflow of the model for a time step
+void set_inflow(LPNSolverInterface& interface, double time, double inflow)
+{
+  std::vector<double> params = {2.0, time, time + 0.01, inflow, inflow};
+  interface.update_block_params("inlet_vessel", params);
+}
+
+// Check that the states of two models are equal
+void check_equal(LPNSolverInterface& interface_1, LPNSolverInterface& interface_2, const std::string& message)
+{
+  double *y_1, *ydot_1, *y_2, *ydot_2;
+  interface_1.get_state_data(y_1, ydot_1);
+  interface_2.get_state_data(y_2, ydot_2);
+  for (int i = 0; i < interface_1.system_size_; i++) {
+    if ((y_1[i] != y_2[i]) || (ydot_1[i] != ydot_2[i])) {
+      throw std::runtime_error(message);
+    }
+  }
+}
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  LPNSolverInterface interface_ref;
+  LPNSolverInterface interface;
+
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test07 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // Load shared library and get interface functions.
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+  interface_ref.load_library(interface_lib);
+  interface.load_library(interface_lib);
+
+  // Set up the same svZeroD model twice
+  std::string file_name = std::string(argv[2]);
+  interface_ref.initialize(file_name);
+  interface.initialize(file_name);
+  interface_ref.set_external_step_size(0.01);
+  interface.set_external_step_size(0.01);
+
+  // Nothing to commit or roll back yet
+  if ((interface.commit_time_step() != 1) || (interface.rollback() != 1)) {
+    throw std::runtime_error("Commit or rollback without trial step or checkpoint succeeded");
+  }
+
+  double time = 0.0;
+  for (int step = 0; step < 20; step++) {
+    double inflow = 1.0 + 0.1 * double(step);
+
+    // Reference model takes the time step with the final inflow
+    set_inflow(interface_ref, time, inflow);
+    interface_ref.increment_time_data(time, nullptr);
+
+    // Coupling iterations with trial inflows converging to the final inflow
+    double *y, *ydot, *y_trial, *ydot_trial;
+    interface.get_state_data(y, ydot);
+    double y_old = y[0];
+    for (int iter = 3; iter >= 0; iter--) {
+      set_inflow(interface, time, inflow + 0.5 * double(iter));
+      if (interface.increment_time_trial(time) != 0) {
+        throw std::runtime_error("Error in trial step");
+      }
+      // Trial steps do not change the state
+      if (y[0] != y_old) {
+        throw std::runtime_error("Trial step changed the state");
+      }
+    }
+    interface.get_trial_state_data(y_trial, ydot_trial);
+    double y_trial_0 = y_trial[0];
+    if (interface.commit_time_step() != 0) {
+      throw std::runtime_error("Error in commit");
+    }
+    if (y[0] != y_trial_0) {
+      throw std::runtime_error("Trial step was not committed");
+    }
+    time += 0.01;
+    check_equal(interface_ref, interface, "Different state in time step " + std::to_string(step));
+
+    // Take a detour with different inflows and roll back
+    if (step == 10) {
+      interface.checkpoint();
+      for (int i = 0; i < 5; i++) {
+        set_inflow(interface, time + 0.01 * double(i), 10.0);
+        interface.increment_time_data(time + 0.01 * double(i), nullptr);
+      }
+      if (interface.rollback() != 0) {
+        throw std::runtime_error("Error in rollback");
+      }
+      check_equal(interface_ref, interface, "Different state after rollback");
+    }
+  }
+
+  return 0;
+}
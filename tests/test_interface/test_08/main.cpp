@@ -0,0 +1,120 @@
+// Test the sensitivity of a time step to the boundary value of a coupling
+// block against finite differences of trial time steps.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+
+// Set the inflow of the model for a time step
+void set_inflow(LPNSolverInterface& interface, double time, double inflow)
+{
+  std::vector<double> params = {2.0, time, time + 0.01, inflow, inflow};
+  interface.update_block_params("inlet_vessel", params);
+}
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  LPNSolverInterface interface;
+
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test08 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // Load shared library and get interface functions.
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+  interface.load_library(interface_lib);
+
+  std::string file_name = std::string(argv[2]);
+  interface.initialize(file_name);
+  interface.set_external_step_size(0.01);
+  int system_size = interface.system_size_;
+
+  // No tangent without a time step
+  std::vector<double> tangent;
+  if (interface.get_block_tangent("inlet_vessel", tangent) != 1) {
+    throw std::runtime_error("Tangent without time step was computed");
+  }
+
+  double time = 0.0;
+  for (int step = 0; step < 20; step++) {
+    set_inflow(interface, time, 1.0 + 0.1 * double(step));
+    interface.increment_time_data(time, nullptr);
+    time += 0.01;
+  }
+
+  // Finite differences of two trial steps with different inflows
+  const double inflow = 3.0;
+  const double delta = 0.01;
+  double *y_trial, *ydot_trial;
+  interface.get_trial_state_data(y_trial, ydot_trial);
+  set_inflow(interface, time, inflow + delta);
+  interface.increment_time_trial(time);
+  std::vector<double> y_delta(y_trial, y_trial + system_size);
+  set_inflow(interface, time, inflow);
+  interface.increment_time_trial(time);
+  if (interface.get_block_tangent("inlet_vessel", tangent) != 0) {
+    throw std::runtime_error("Could not compute tangent");
+  }
+  double tangent_max = 0.0;
+  for (int i = 0; i < system_size; i++) {
+    tangent_max = std::max(tangent_max, std::abs(tangent[i]));
+  }
+  for (int i = 0; i < system_size; i++) {
+    double difference = (y_delta[i] - y_trial[i]) / delta;
+    if (std::abs(tangent[i] - difference) > 1e-6 * tangent_max) {
+      throw std::runtime_error("Tangent does not match finite differences for degree-of-freedom " + std::to_string(i));
+    }
+  }
+
+  // The inlet pressure increases with the inflow
+  std::vector<int> IDs;
+  interface.get_block_node_IDs("inlet_vessel", IDs);
+  if (tangent[IDs[3]] <= 0.0) {
+    throw std::runtime_error("Wrong sign of the inlet pressure derivative");
+  }
+
+  // The tangent of a committed time step is the tangent of the trial step
+  std::vector<double> tangent_commit;
+  interface.commit_time_step();
+  interface.get_block_tangent("inlet_vessel", tangent_commit);
+  if (tangent_commit != tangent) {
+    throw std::runtime_error("Different tangent after commit");
+  }
+
+  // Only blocks with a prescribed flow or pressure have a tangent
+  if ((interface.get_block_tangent("OUT", tangent) != 1) ||
+      (interface.get_block_tangent("unknown", tangent) != 1)) {
+    throw std::runtime_error("Tangent of wrong block was computed");
+  }
+
+  // Errors are reported by the return value
+  if (interface.lpn_get_block_tangent_(-1, "inlet_vessel", tangent.data(), system_size) != 1) {
+    throw std::runtime_error("Unknown problem ID was not detected");
+  }
+  if (interface.lpn_get_block_tangent_(interface.problem_id_, "inlet_vessel", tangent.data(), system_size - 1) != 1) {
+    throw std::runtime_error("Wrong vector size was not detected");
+  }
+
+  return 0;
+}
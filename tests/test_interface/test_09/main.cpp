@@ -0,0 +1,106 @@
+// Test that updating single block parameters during a simulation changes the
+// steady state of the model accordingly.
+
+#include "../LPNSolverInterface/LPNSolverInterface.h"
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <string>
+
+//------
+// main
+//------
+//
+int main(int argc, char** argv)
+{
+  LPNSolverInterface interface;
+
+  if (argc != 3) {
+    std::runtime_error("Usage: svZeroD_interface_test09 <path_to_svzeroDPlus_build_folder> <path_to_json_file>");
+  }
+
+  // Load shared library and get interface functions.
+  // File extension of the shared library depends on the system
+  std::string svzerod_build_path = std::string(argv[1]);
+  std::string interface_lib_path = svzerod_build_path + "/src/interface/libsvzero_interface";
+  std::string interface_lib_so = interface_lib_path + ".so";
+  std::string interface_lib_dylib = interface_lib_path + ".dylib";
+  std::ifstream lib_so_exists(interface_lib_so);
+  std::ifstream lib_dylib_exists(interface_lib_dylib);
+  std::string interface_lib;
+  if (lib_so_exists) {
+    interface_lib = interface_lib_so;
+  } else if (lib_dylib_exists) {
+    interface_lib = interface_lib_dylib;
+  } else {
+    throw std::runtime_error("Could not find shared libraries " + interface_lib_so + " or " + interface_lib_dylib);
+  }
+  interface.load_library(interface_lib);
+
+  std::string file_name = std::string(argv[2]);
+  interface.initialize(file_name);
+  const double time_step_size = 0.01;
+  interface.set_external_step_size(time_step_size * (interface.num_output_steps_ - 1));
+
+  // Constant inflow
+  const double inflow = 2.0;
+  std::vector<double> params = {2.0, 0.0, 1000.0, inflow, inflow};
+  interface.update_block_params("inlet_vessel", params);
+
+  std::vector<int> IDs;
+  interface.get_block_node_IDs("branch0_seg0", IDs);
+  int inlet_pressure_id = IDs[2];
+  int outlet_pressure_id = IDs[5];
+  interface.get_block_node_IDs("OUT", IDs);
+  int outlet_flow_id = IDs[1];
+
+  double time = 0.0;
+  for (int change = 0; change < 3; change++) {
+    // Change the resistances of the vessel and the outlet
+    std::vector<double> vessel_params(4);
+    interface.read_block_params("branch0_seg0", vessel_params);
+    vessel_params[0] *= 1.5;
+    interface.update_block_params("branch0_seg0", vessel_params);
+    std::vector<double> outlet_params(4);
+    interface.read_block_params("OUT", outlet_params);
+    outlet_params[0] *= 2.0;
+    outlet_params[2] *= 0.5;
+    interface.update_block_params("OUT", outlet_params);
+
+    // Pressure drops of the steady state with the new resistances
+    for (int step = 0; step < 2000; step++) {
+      interface.increment_time_data(time, nullptr);
+      time += time_step_size;
+    }
+    double *y, *ydot;
+    interface.get_state_data(y, ydot);
+    double vessel_pressure_drop = y[inlet_pressure_id] - y[outlet_pressure_id];
+    double outlet_pressure_drop = y[outlet_pressure_id] - outlet_params[3];
+    if ((std::abs(y[outlet_flow_id] - inflow) > 1e-6) ||
+        (std::abs(vessel_pressure_drop - vessel_params[0] * inflow) > 1e-6 * vessel_pressure_drop) ||
+        (std::abs(outlet_pressure_drop - (outlet_params[0] + outlet_params[2]) * inflow) > 1e-6 * outlet_pressure_drop)) {
+      throw std::runtime_error("Wrong steady state after parameter change " + std::to_string(change));
+    }
+  }
+
+  // Add a stenosis to the vessel and remove it again
+  std::vector<double> vessel_params(4);
+  interface.read_block_params("branch0_seg0", vessel_params);
+  for (double stenosis_coeff : {0.5 * vessel_params[0], 0.0}) {
+    vessel_params[3] = stenosis_coeff;
+    interface.update_block_params("branch0_seg0", vessel_params);
+    for (int step = 0; step < 2000; step++) {
+      interface.increment_time_data(time, nullptr);
+      time += time_step_size;
+    }
+    double *y, *ydot;
+    interface.get_state_data(y, ydot);
+    double vessel_pressure_drop = y[inlet_pressure_id] - y[outlet_pressure_id];
+    double expected_pressure_drop = (vessel_params[0] + stenosis_coeff * inflow) * inflow;
+    if (std::abs(vessel_pressure_drop - expected_pressure_drop) > 1e-6 * expected_pressure_drop) {
+      throw std::runtime_error("Wrong steady state with stenosis coefficient " + std::to_string(stenosis_coeff));
+    }
+  }
+
+  return 0;
+}
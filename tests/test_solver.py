@@ -171,6 +171,22 @@ def test_steady_flow_bifurcationr_r1():
     )  # daughter2 outlet flow
 
 
+def test_steady_flow_bifurcationr_r1_sparse_lu():
+    results = run_test_case_by_name("steadyFlow_bifurcationR_R1_sparseLU")
+    assert np.isclose(
+        get_result(results, "pressure_in", 0, -1), 1100.0, rtol=RTOL_PRES
+    )  # parent inlet pressure
+    assert np.isclose(
+        get_result(results, "pressure_out", 1, -1), 350.0, rtol=RTOL_PRES
+    )  # daughter1 outlet pressure
+    assert np.isclose(
+        get_result(results, "flow_in", 0, -1), 5.0, rtol=RTOL_FLOW
+    )  # parent inlet flow
+    assert np.isclose(
+        get_result(results, "flow_out", 2, -1), 2.5, rtol=RTOL_FLOW
+    )  # daughter2 outlet flow
+
+
 def test_steady_flow_bifurcationr_r2():
     results = run_test_case_by_name("steadyFlow_bifurcationR_R2")
     assert np.isclose(
@@ -267,6 +283,58 @@ def test_pulsatile_flow_r_rcr():
     )  # outlet flow
 
 
+def test_pulsatile_flow_r_rcr_cycle_to_cycle():
+    results = run_test_case_by_name("pulsatileFlow_R_RCR_cycleToCycle")
+    assert len(results["pressure_in"][0]) == 201  # only last cycle
+    assert np.isclose(
+        get_result(results, "pressure_in", 0, -1), 3494.0316427421785, rtol=1.0e-6
+    )  # inlet pressure
+    assert np.isclose(
+        get_result(results, "pressure_out", 0, -1), 3274.0316427421762, rtol=1.0e-6
+    )  # outlet pressure
+    assert np.isclose(
+        get_result(results, "flow_in", 0, -1), 2.2, rtol=RTOL_FLOW
+    )  # inlet flow
+
+
+def test_pulsatile_flow_r_rcr_periodic_steady_state():
+    results = run_test_case_by_name("pulsatileFlow_R_RCR_periodicSteadyState")
+    assert np.isclose(
+        get_result(results, "pressure_in", 0, -1), 4580.2355156005424, rtol=1.0e-8
+    )  # inlet pressure
+    assert np.isclose(
+        get_result(results, "pressure_out", 0, -1), 4360.2355156005415, rtol=1.0e-8
+    )  # outlet pressure
+    assert np.isclose(
+        get_result(results, "flow_in", 0, -1), 2.2, rtol=RTOL_FLOW
+    )  # inlet flow
+
+
+def test_pulsatile_flow_r_steady_pressure_spline():
+    results = run_test_case_by_name("pulsatileFlow_R_steadyPressure_spline")
+    time = np.linspace(0.0, 1.0, 101)
+    flow = 5.0 + 2.0 * np.sin(2.0 * np.pi * time)
+    assert np.allclose(
+        results["flow_in"][0], flow, atol=5.0e-3
+    )  # inlet flow (linear interpolation is off by up to 0.14)
+    assert np.allclose(
+        results["pressure_in"][0], 1000.0 + 100.0 * flow, atol=0.5
+    )  # inlet pressure
+
+
+def test_pulsatile_flow_r_steady_pressure_pchip():
+    results = run_test_case_by_name("pulsatileFlow_R_steadyPressure_pchip")
+    flow = np.array(results["flow_in"][0])
+    assert np.all(flow > -1.0e-3)  # no undershoot (spline: -0.11)
+    assert np.all(flow < 1.0 + 1.0e-3)  # no overshoot (spline: 1.10)
+    assert np.isclose(
+        get_result(results, "flow_in", 0, 50), 1.0, rtol=1.0e-6
+    )  # inlet flow in the flat part of the waveform
+    assert np.isclose(
+        get_result(results, "pressure_in", 0, 50), 1100.0, rtol=1.0e-6
+    )  # inlet pressure
+
+
 def test_pulsatile_flow_r_coronary():
     results = run_test_case_by_name("pulsatileFlow_R_coronary")
     assert np.isclose(
@@ -305,6 +373,30 @@ def test_pulsatile_flow_cstenosis_steady_pressure():
     )  # outlet flow
 
 
+def test_pulsatile_flow_cstenosis_steady_pressure_jacobian_reuse():
+    results = run_test_case_by_name(
+        "pulsatileFlow_CStenosis_steadyPressure_jacobianReuse"
+    )
+    assert np.isclose(
+        get_result(results, "pressure_in", 0, -439),
+        0.5931867478176258,
+        rtol=1.0e-5,
+    )  # inlet pressure
+    assert np.isclose(
+        get_result(results, "pressure_out", 0, -439), 0.1, rtol=1.0e-5
+    )  # outlet pressure
+    assert np.isclose(
+        get_result(results, "flow_in", 0, -439),
+        0.7022833221028071,
+        rtol=1.0e-5,
+    )  # inlet flow
+    assert np.isclose(
+        get_result(results, "flow_out", 0, -439),
+        0.7025195223805801,
+        rtol=1.0e-5,
+    )  # outlet flow
+
+
 def test_steady_flow_confluencer_r():
     results = run_test_case_by_name("steadyFlow_confluenceR_R")
     assert np.isclose(
@@ -361,6 +453,22 @@ def test_closed_loop_heart_single_vessel():
     )  # aortic inflow
 
 
+def test_closed_loop_heart_single_vessel_adaptive():
+    results = run_test_case_by_name("closedLoopHeart_singleVessel_adaptive")
+    assert np.isclose(
+        np.mean(np.array(results["pressure_in"][0])), 55.703641631129, rtol=1.0e-3
+    )  # mean aortic pressure
+    assert np.isclose(
+        np.amax(np.array(results["pressure_in"][0])), 73.97432522258265, rtol=1.0e-3
+    )  # max aortic pressure
+    assert np.isclose(
+        np.amin(np.array(results["pressure_in"][0])), 0.0, rtol=1.0e-3
+    )  # min aortic pressure
+    assert np.isclose(
+        np.mean(np.array(results["flow_in"][0])), 43.21039307754263, rtol=1.0e-3
+    )  # aortic inflow
+
+
 def test_closed_loop_heart_with_coronaries():
     results = run_test_case_by_name("closedLoopHeart_withCoronaries")
     assert np.isclose(